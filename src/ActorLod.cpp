@@ -0,0 +1,59 @@
+namespace ActorLod
+{
+    constexpr std::array<int, kTierCount> tick_intervals = {1, 2, 4};
+    constexpr float view_cos = 0.5f; // Within 60 degrees of the camera's forward counts as in view
+
+    bool g_has_camera = false;
+    RE::NiPoint3 g_camera_pos;
+    RE::NiPoint3 g_camera_forward;
+
+    void BeginTick()
+    {
+        auto *camera = RE::PlayerCamera::GetSingleton();
+        g_has_camera = camera && camera->cameraRoot;
+        if (!g_has_camera)
+            return;
+        const auto &world = camera->cameraRoot->world;
+        g_camera_pos = world.translate;
+        // The camera looks along its local y axis
+        g_camera_forward = RE::NiPoint3(world.rotate.entry[0][1], world.rotate.entry[1][1], world.rotate.entry[2][1]);
+    }
+
+    Tier GetTier(RE::Actor *actor)
+    {
+        if (!g_has_camera || actor->IsPlayerRef())
+            return kNear;
+        const auto &config = Config::Current();
+        RE::NiPoint3 to_actor = actor->GetPosition() - g_camera_pos;
+        const float distance = to_actor.Unitize();
+        int tier = kNear;
+        if (distance > config.lod_far_distance)
+            tier = kFar;
+        else if (distance > config.lod_near_distance)
+            tier = kMid;
+        // Off-screen actors drop one tier, a nearby one is still checked every other tick
+        if (distance > 0.0f && to_actor.Dot(g_camera_forward) < view_cos)
+            tier = std::min(tier + 1, static_cast<int>(kFar));
+        return static_cast<Tier>(tier);
+    }
+
+    bool IsDue(RE::Actor *actor, Globals::ActorState &state)
+    {
+        // Only a move's first check is promoted, the rest of it follows the actor's tier
+        if (state.lod_promote)
+        {
+            state.lod_promote = false;
+            state.lod_tier = kNear;
+            state.lod_wait = 0;
+            return true;
+        }
+        if (state.lod_wait > 0)
+        {
+            --state.lod_wait;
+            return false;
+        }
+        state.lod_tier = GetTier(actor);
+        state.lod_wait = tick_intervals[state.lod_tier] - 1;
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+// Level of detail of an actor's ledge checks, by distance from the camera and whether the actor
+// is in view. The player is always checked in full, other actors only on the first check after they
+// start an attack or dodge.
+namespace ActorLod
+{
+    enum Tier
+    {
+        kNear, // Every tick, every ray
+        kMid,  // Every other tick, the reduced ring
+        kFar,  // Every fourth tick, the reduced ring, only near a cached ledge
+        kTierCount
+    };
+
+    // Captures the camera for this tick's tiers.
+    void BeginTick();
+
+    // Retiers the actor and returns whether its check is due this tick.
+    bool IsDue(RE::Actor *actor, Globals::ActorState &state);
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "AnimationTags.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace AnimationTags
+{
+    bool Equals(std::string_view text, std::string_view tag)
+    {
+        return std::ranges::equal(text, tag, [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+        });
+    }
+
+    Type StartType(std::string_view tag, const Toggles &toggles)
+    {
+        if (toggles.attacks && Equals(tag, "PowerAttack_Start_end"))
+            return kAttack;
+        if (toggles.dodges)
+        {
+            if (Equals(tag, "MCO_DodgeInitiate"))
+                return kDmcoDodge;
+            if (Equals(tag, "RollTrigger") || Equals(tag, "SidestepTrigger"))
+                return kTudmrDodge;
+            if (Equals(tag, "TKDR_DodgeStart"))
+                return kTkDodge;
+            if (Equals(tag, "MCO_DisableSecondDodge"))
+                return kOldDmcoDodge;
+        }
+        if (toggles.slides && Equals(tag, "SlideStart"))
+            return kSlide;
+        return kNone;
+    }
+
+    bool IsRelevant(std::string_view tag, std::string_view payload)
+    {
+        constexpr std::string_view tags[] = {"PowerAttack_Start_end", "MCO_DodgeInitiate", "RollTrigger", "SidestepTrigger",
+                                             "TKDR_DodgeStart", "MCO_DisableSecondDodge", "SlideStart", "attackStop",
+                                             "RollStop", "TKDR_DodgeEnd", "EnableBumper", "SlideStop",
+                                             "InterruptCast", "IdleStop", "JumpUp", "MTstate"};
+        return Equals(payload, "$DMCO_Reset") || std::ranges::any_of(tags, [&](std::string_view known) { return Equals(tag, known); });
+    }
+
+    bool IsEnd(int animation_type, bool is_attacking, std::string_view tag, std::string_view payload)
+    {
+        if (!is_attacking)
+            return false;
+        if ((animation_type == kAttack && Equals(tag, "attackStop")) ||
+            (animation_type == kDmcoDodge && Equals(payload, "$DMCO_Reset")) ||
+            (animation_type == kTudmrDodge && Equals(tag, "RollStop")) ||
+            (animation_type == kTkDodge && Equals(tag, "TKDR_DodgeEnd")) ||
+            (animation_type == kOldDmcoDodge && Equals(tag, "EnableBumper")) ||
+            (animation_type == kSlide && Equals(tag, "SlideStop")) ||
+            animation_type == kNone)
+            return true;
+        if (animation_type != kAttack && animation_type != kTkDodge && Equals(tag, "InterruptCast"))
+            return true;
+        if (animation_type != kTkDodge && Equals(tag, "IdleStop"))
+            return true;
+        if (Equals(tag, "JumpUp") || Equals(tag, "MTstate"))
+            return true;
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string_view>
+
+// Which animation graph events start and end the moves ledge blocking covers. Tags compare case
+// insensitively, like BSFixedString. No game headers here, this file is also built into the tools.
+namespace AnimationTags
+{
+    // The move an animation belongs to, stored in ActorState::animation_type.
+    enum Type : int
+    {
+        kNone = 0,
+        kAttack = 1,       // Any attack
+        kDmcoDodge = 2,    // DMCO
+        kTudmrDodge = 3,   // TUDMR
+        kTkDodge = 4,      // TK Dodge RE
+        kOldDmcoDodge = 5, // Old DMCO
+        kSlide = 6         // Crouch Sliding
+    };
+
+    // The [General] blocking toggles.
+    struct Toggles
+    {
+        bool attacks = true;
+        bool dodges = true;
+        bool slides = true;
+    };
+
+    // The move tag starts, kNone if it starts none of the enabled ones.
+    Type StartType(std::string_view tag, const Toggles &toggles);
+
+    // Whether the event can start or end any move, a cheap filter before the actor is looked up.
+    bool IsRelevant(std::string_view tag, std::string_view payload);
+
+    // Whether tag or payload ends the actor's current move.
+    bool IsEnd(int animation_type, bool is_attacking, std::string_view tag, std::string_view payload);
+}
\ No newline at end of file
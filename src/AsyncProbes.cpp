@@ -0,0 +1,98 @@
+namespace AsyncProbes
+{
+    struct Finished
+    {
+        Utils::ProbeRequest request;
+        Utils::ProbeResult result;
+    };
+
+    // Shared with the worker
+    std::mutex g_queue_lock;
+    std::condition_variable_any g_queue_signal;
+    std::deque<std::pair<RE::FormID, Utils::ProbeRequest>> g_requests;
+    std::unordered_set<RE::FormID> g_queued;
+    std::unordered_map<RE::FormID, Finished> g_finished;
+    std::jthread g_worker;
+
+    // Main thread only
+    std::unordered_map<RE::FormID, std::chrono::steady_clock::time_point> g_fresh;
+
+    void WorkerLoop(std::stop_token stop_token)
+    {
+        while (true)
+        {
+            std::pair<RE::FormID, Utils::ProbeRequest> job;
+            {
+                std::unique_lock lock(g_queue_lock);
+                if (!g_queue_signal.wait(lock, stop_token, [] { return !g_requests.empty(); }))
+                    return;
+                job = std::move(g_requests.front());
+                g_requests.pop_front();
+            }
+
+            // Waits out the physics step, rays then see the world the step left behind
+            Finished finished{std::move(job.second), {}};
+            {
+                RE::BSReadLockGuard world_lock(finished.request.bhk_world->worldLock);
+                Utils::RunProbe(finished.request, finished.result);
+            }
+            std::scoped_lock lock(g_queue_lock);
+            g_queued.erase(job.first);
+            g_finished[job.first] = std::move(finished);
+        }
+    }
+
+    void Submit(RE::FormID actor_id, Utils::ProbeRequest request)
+    {
+        {
+            std::scoped_lock lock(g_queue_lock);
+            if (!g_queued.insert(actor_id).second)
+                return;
+            g_requests.emplace_back(actor_id, std::move(request));
+            if (!g_worker.joinable())
+                g_worker = std::jthread(WorkerLoop);
+        }
+        g_queue_signal.notify_one();
+    }
+
+    bool TakeResult(RE::FormID actor_id, Utils::ProbeRequest &request, Utils::ProbeResult &result)
+    {
+        {
+            std::scoped_lock lock(g_queue_lock);
+            const auto it = g_finished.find(actor_id);
+            if (it == g_finished.end())
+                return false;
+            request = std::move(it->second.request);
+            result = std::move(it->second.result);
+            g_finished.erase(it);
+        }
+        g_fresh[actor_id] = request.issued;
+        return true;
+    }
+
+    bool HasLedgeResult(RE::FormID actor_id)
+    {
+        std::scoped_lock lock(g_queue_lock);
+        const auto it = g_finished.find(actor_id);
+        return it != g_finished.end() && it->second.result.ledge_detected;
+    }
+
+    bool IsStale(RE::FormID actor_id)
+    {
+        const auto it = g_fresh.find(actor_id);
+        return it == g_fresh.end() ||
+               std::chrono::steady_clock::now() - it->second > std::chrono::milliseconds(Config::Current().async_max_staleness);
+    }
+
+    void MarkFresh(RE::FormID actor_id)
+    {
+        g_fresh[actor_id] = std::chrono::steady_clock::now();
+    }
+
+    void Prune()
+    {
+        std::erase_if(g_fresh, [](const auto &entry) { return !Globals::g_actor_states.contains(entry.first); });
+        std::scoped_lock lock(g_queue_lock);
+        std::erase_if(g_finished, [](const auto &entry) { return !Globals::g_actor_states.contains(entry.first); });
+    }
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+// Ledge probes run on a background thread, their results are applied on a later tick.
+namespace AsyncProbes
+{
+    // Queues a probe for the actor, unless one is already queued.
+    void Submit(RE::FormID actor_id, Utils::ProbeRequest request);
+
+    // Moves out the actor's finished probe, false if there is none.
+    bool TakeResult(RE::FormID actor_id, Utils::ProbeRequest &request, Utils::ProbeResult &result);
+
+    // True if a finished probe of the actor that hasn't been applied yet found a ledge.
+    bool HasLedgeResult(RE::FormID actor_id);
+
+    // True if the last result applied for the actor was requested longer than the max staleness ago.
+    bool IsStale(RE::FormID actor_id);
+
+    // Records that the actor was just checked synchronously.
+    void MarkFresh(RE::FormID actor_id);
+
+    // Forgets actors that are no longer tracked.
+    void Prune();
+}
\ No newline at end of file
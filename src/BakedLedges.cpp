@@ -0,0 +1,95 @@
+namespace BakedLedges
+{
+    const char *mapPath = "Data\\SKSE\\Plugins\\AnimationLedgeBlockNG.ledgemap";
+
+    LedgeMap::MappedFile g_file;
+    LedgeMap::View g_view;
+    bool g_loaded = false;
+
+    // Per cell: hash of its worldspace (exteriors) or its own editor ID (interiors), 0 if not baked
+    std::unordered_map<RE::FormID, std::uint64_t> g_space_hashes;
+
+    void Load()
+    {
+        g_loaded = false;
+        g_space_hashes.clear();
+        g_view = LedgeMap::View{};
+        if (!g_file.Open(mapPath))
+        {
+            logger::info("No baked ledge map at {}"sv, mapPath);
+            return;
+        }
+        std::string error;
+        if (!g_view.Open(g_file.Bytes(), error))
+        {
+            logger::error("Ignoring baked ledge map {}: {}"sv, mapPath, error);
+            g_file.Close();
+            return;
+        }
+        g_loaded = true;
+        logger::info("Mapped baked ledge map with {} cells"sv, g_view.Cells().size());
+    }
+
+    std::uint64_t GetSpaceHash(RE::TESObjectCELL *cell)
+    {
+        const auto cell_id = cell->GetFormID();
+        if (const auto it = g_space_hashes.find(cell_id); it != g_space_hashes.end())
+            return it->second;
+
+        std::uint64_t space_hash = 0;
+        if (cell->IsExteriorCell())
+        {
+            auto *worldspace = cell->GetRuntimeData().worldSpace;
+            auto *coordinates = cell->GetCoordinates();
+            if (worldspace && coordinates)
+            {
+                space_hash = LedgeMap::HashEditorID(worldspace->GetFormEditorID());
+                if (!g_view.FindCell(space_hash, coordinates->cellX, coordinates->cellY))
+                    space_hash = 0;
+            }
+        }
+        else
+        {
+            space_hash = LedgeMap::HashEditorID(cell->GetFormEditorID());
+            if (!g_view.FindCell(space_hash, 0, 0))
+                space_hash = 0;
+        }
+        g_space_hashes[cell_id] = space_hash;
+        return space_hash;
+    }
+
+    bool HasCell(RE::TESObjectCELL *cell)
+    {
+        return g_loaded && cell && GetSpaceHash(cell) != 0;
+    }
+
+    float DistanceToNearestLedge(RE::TESObjectCELL *cell, const RE::NiPoint3 &pos, float max_distance)
+    {
+        if (!g_loaded || !cell)
+            return max_distance;
+        const std::uint64_t space_hash = GetSpaceHash(cell);
+        if (!space_hash)
+            return max_distance;
+        if (cell->IsInteriorCell())
+        {
+            const auto *record = g_view.FindCell(space_hash, 0, 0);
+            return LedgeMap::SampleDistance(g_view.GetField(*record), pos.x, pos.y, max_distance);
+        }
+
+        // Every exterior cell within reach, edges near a border live in the neighbour's field
+        float best = max_distance;
+        const auto min_x = static_cast<std::int32_t>(std::floor((pos.x - max_distance) / LedgeMap::cell_size));
+        const auto max_x = static_cast<std::int32_t>(std::floor((pos.x + max_distance) / LedgeMap::cell_size));
+        const auto min_y = static_cast<std::int32_t>(std::floor((pos.y - max_distance) / LedgeMap::cell_size));
+        const auto max_y = static_cast<std::int32_t>(std::floor((pos.y + max_distance) / LedgeMap::cell_size));
+        for (std::int32_t y = min_y; y <= max_y; ++y)
+        {
+            for (std::int32_t x = min_x; x <= max_x; ++x)
+            {
+                if (const auto *record = g_view.FindCell(space_hash, x, y); record)
+                    best = LedgeMap::SampleDistance(g_view.GetField(*record), pos.x, pos.y, best);
+            }
+        }
+        return best;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace BakedLedges
+{
+    // Memory-maps the ledge map baked by the ledgebake tool, if there is one.
+    void Load();
+
+    // True if the baked map has the cell.
+    bool HasCell(RE::TESObjectCELL *cell);
+
+    // Distance from pos to the nearest baked ledge edge in the same interior or worldspace,
+    // max_distance if there is none closer.
+    float DistanceToNearestLedge(RE::TESObjectCELL *cell, const RE::NiPoint3 &pos, float max_distance);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+namespace BodyCache
+{
+    constexpr std::size_t table_size = 256; // Per thread, a forest around the actors fits easily
+
+    struct Entry
+    {
+        const RE::hkpRigidBody *rigid_body = nullptr;
+        RE::FormID owner_id = 0; // The reference the body belonged to when classified
+        std::uint32_t generation = 0;
+        Body body;
+    };
+
+    // Bumped on every detach, entries of an older generation are stale
+    std::atomic<std::uint32_t> g_generation = 1;
+
+    // Each thread probing has its own table, so lookups take no lock
+    thread_local std::array<Entry, table_size> g_table;
+
+    RE::TESObjectREFR *GetOwner(const RE::hkpRigidBody *rigid_body)
+    {
+        auto *user_data = rigid_body->GetUserData();
+        return user_data ? user_data->As<RE::TESObjectREFR>() : nullptr;
+    }
+
+    Body DescribeOwner(RE::TESObjectREFR *hit_ref)
+    {
+        Body body;
+        if (!hit_ref)
+            return body;
+        auto *hit_object = hit_ref->GetBaseObject();
+        if (hit_object && (hit_object->Is(RE::FormType::Flora) || hit_object->Is(RE::FormType::Tree)))
+        {
+            body.is_plant = true;
+            body.ref_pos = hit_ref->GetPosition();
+        }
+        return body;
+    }
+
+    Body Describe(const RE::hkpRigidBody *rigid_body)
+    {
+        return DescribeOwner(GetOwner(rigid_body));
+    }
+
+    const Body &Lookup(const RE::hkpRigidBody *rigid_body)
+    {
+        // Bodies are at least 16 byte aligned, the low bits carry nothing
+        auto &entry = g_table[(reinterpret_cast<std::uintptr_t>(rigid_body) >> 4) % table_size];
+        const auto generation = g_generation.load(std::memory_order_relaxed);
+        auto *owner = GetOwner(rigid_body);
+        const RE::FormID owner_id = owner ? owner->GetFormID() : 0;
+        if (entry.rigid_body != rigid_body || entry.owner_id != owner_id || entry.generation != generation)
+        {
+            entry.rigid_body = rigid_body;
+            entry.owner_id = owner_id;
+            entry.generation = generation;
+            entry.body = DescribeOwner(owner);
+        }
+        return entry.body;
+    }
+
+    void Invalidate()
+    {
+        g_generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    RE::BSEventNotifyControl DetachEventSink::ProcessEvent(
+        const RE::TESCellAttachDetachEvent *a_event,
+        RE::BSTEventSource<RE::TESCellAttachDetachEvent> *)
+    {
+        // A detaching reference takes its rigid bodies with it
+        if (a_event && !a_event->attached)
+            Invalidate();
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    DetachEventSink *DetachEventSink::GetSingleton()
+    {
+        static DetachEventSink singleton;
+        return &singleton;
+    }
+}
\ No newline at end of file
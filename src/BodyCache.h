@@ -0,0 +1,31 @@
+#pragma once
+
+// What a ray hit's rigid body belongs to, remembered per body so repeated hits on the same tree or
+// rock skip the base object lookups. An entry is only used while the body still belongs to the same
+// reference, a freed body's address reused by another one misses.
+namespace BodyCache
+{
+    struct Body
+    {
+        bool is_plant = false;  // Flora or Tree, a ray stops at the reference's base instead
+        RE::NiPoint3 ref_pos;   // Position of the plant's reference
+    };
+
+    // Classifies the body without the cache.
+    Body Describe(const RE::hkpRigidBody *rigid_body);
+
+    // Classifies the body through the calling thread's table.
+    const Body &Lookup(const RE::hkpRigidBody *rigid_body);
+
+    // Forgets every classification, for when many bodies are freed at once.
+    void Invalidate();
+
+    class DetachEventSink final : public RE::BSTEventSink<RE::TESCellAttachDetachEvent>
+    {
+    public:
+        RE::BSEventNotifyControl ProcessEvent(
+            const RE::TESCellAttachDetachEvent *a_event,
+            RE::BSTEventSource<RE::TESCellAttachDetachEvent> *) override;
+        static DetachEventSink *GetSingleton();
+    };
+}
\ No newline at end of file
@@ -1,5 +1,81 @@
 namespace Config
 {
+    const char *iniPath = "Data\\SKSE\\Plugins\\AnimationLedgeBlockNG.ini";
+
+    // Replaced snapshots are released this long after, Current() references don't outlive that
+    constexpr auto retire_grace = std::chrono::seconds(10);
+
+    struct Published
+    {
+        std::shared_ptr<const Snapshot> snapshot;
+        std::chrono::steady_clock::time_point replaced;
+    };
+
+    std::atomic<const Snapshot *> g_current{nullptr};
+    // The current snapshot last, checks holding an older one through Acquire keep it alive themselves
+    std::vector<Published> g_snapshots;
+    std::mutex g_publish_lock;
+    std::jthread g_watcher;
+
+    const Snapshot &Current()
+    {
+        return *g_current.load(std::memory_order_acquire);
+    }
+
+    std::shared_ptr<const Snapshot> Acquire()
+    {
+        std::scoped_lock lock(g_publish_lock);
+        return g_snapshots.back().snapshot;
+    }
+
+    void Publish(Snapshot snapshot)
+    {
+        snapshot.ledge_reach = snapshot.ledge_distance + 64.0f; // Navmesh edges sit a little short of the actual drop
+        snapshot.field_margin = snapshot.ledge_distance + 128.0f;
+        snapshot.probes.drop_threshold = snapshot.drop_threshold;
+        snapshot.probes.ledge_distance = snapshot.ledge_distance;
+        snapshot.probes.ground_leeway = snapshot.ground_leeway;
+        snapshot.probes.refine_steps = snapshot.refine_steps;
+        snapshot.probes.Derive();
+        std::scoped_lock lock(g_publish_lock);
+        const auto now = std::chrono::steady_clock::now();
+        if (!g_snapshots.empty())
+            g_snapshots.back().replaced = now;
+        std::erase_if(g_snapshots, [&](const Published &published) { return now - published.replaced > retire_grace; });
+        g_snapshots.push_back({std::make_shared<const Snapshot>(snapshot), {}});
+        g_current.store(g_snapshots.back().snapshot.get(), std::memory_order_release);
+    }
+
+    void ReadSnapshot(const CSimpleIniA &ini, Snapshot &snapshot)
+    {
+        snapshot.disable_on_stairs = ini.GetBoolValue("General", "DisableOnStairs", snapshot.disable_on_stairs);
+        snapshot.enable_for_attacks = ini.GetBoolValue("General", "EnableAttackBlocking", snapshot.enable_for_attacks);
+        snapshot.enable_for_dodges = ini.GetBoolValue("General", "EnableDodgeBlocking", snapshot.enable_for_dodges);
+        snapshot.enable_for_slides = ini.GetBoolValue("General", "EnableSlideBlocking", snapshot.enable_for_slides);
+
+        snapshot.teleport = ini.GetBoolValue("Tweaks", "Teleport", snapshot.teleport);
+        snapshot.valid_safe_point_distance = static_cast<float>(ini.GetDoubleValue("Tweaks", "ValidSafePointDistance", snapshot.valid_safe_point_distance));
+
+        snapshot.drop_threshold = static_cast<float>(ini.GetDoubleValue("Tweaks", "DropThreshold", snapshot.drop_threshold));
+        if (snapshot.drop_threshold > 600.0f)
+            snapshot.drop_threshold = 590.0f;
+        snapshot.ledge_distance = static_cast<float>(ini.GetDoubleValue("Tweaks", "LedgeDistance", snapshot.ledge_distance));
+        snapshot.ground_leeway = static_cast<float>(ini.GetDoubleValue("Tweaks", "GroundLeeway", snapshot.ground_leeway));
+        snapshot.jump_duration = static_cast<float>(ini.GetDoubleValue("Tweaks", "JumpDuration", snapshot.jump_duration));
+        snapshot.memory_duration = ini.GetLongValue("Tweaks", "MemoryDuration", snapshot.memory_duration);
+        snapshot.memory_duration = std::max(snapshot.memory_duration, 1);
+
+        snapshot.refine_steps = ini.GetLongValue("Performance", "RefineSteps", snapshot.refine_steps);
+        snapshot.refine_steps = std::clamp(snapshot.refine_steps, 1, 6);
+        snapshot.async_max_staleness = ini.GetLongValue("Performance", "AsyncMaxStaleness", snapshot.async_max_staleness);
+        snapshot.async_max_staleness = std::clamp(snapshot.async_max_staleness, 11, 1000);
+        snapshot.frame_budget = static_cast<float>(ini.GetDoubleValue("Performance", "FrameBudget", snapshot.frame_budget));
+        snapshot.frame_budget = std::clamp(snapshot.frame_budget, 0.5f, 50.0f);
+        snapshot.lod_near_distance = static_cast<float>(ini.GetDoubleValue("Performance", "LodNearDistance", snapshot.lod_near_distance));
+        snapshot.lod_far_distance = static_cast<float>(ini.GetDoubleValue("Performance", "LodFarDistance", snapshot.lod_far_distance));
+        snapshot.lod_far_distance = std::max(snapshot.lod_far_distance, snapshot.lod_near_distance);
+    }
+
     void SetUpLog()
     {
         auto logs_folder = SKSE::log::log_directory();
@@ -33,9 +109,8 @@ namespace Config
         case 4:
             spdlog::set_level(spdlog::level::trace);
             break;
-        case 10:
+        case 10: // Markers too, LoadConfig turns them on
             spdlog::set_level(spdlog::level::trace);
-            Globals::show_markers = true;
             break;
         default:
             Globals::log_level = 2;
@@ -48,93 +123,262 @@ namespace Config
         CSimpleIniA ini;
         ini.SetUnicode();
 
-        SI_Error rc = ini.LoadFile("Data\\SKSE\\Plugins\\AnimationLedgeBlockNG.ini");
+        SI_Error rc = ini.LoadFile(iniPath);
         if (rc < 0)
         {
             logger::warn("Could not load AnimationLedgeBlockNG.ini, using defaults"sv);
         }
 
         Globals::use_spell_toggle = ini.GetBoolValue("General", "UseTogglePower", Globals::use_spell_toggle);
+        Snapshot snapshot;
+        ReadSnapshot(ini, snapshot);
 
-        Globals::disable_on_stairs = ini.GetBoolValue("General", "DisableOnStairs", Globals::disable_on_stairs);
         Globals::enable_for_npcs = ini.GetBoolValue("General", "EnableNPCs", Globals::enable_for_npcs);
-        Globals::enable_for_attacks = ini.GetBoolValue("General", "EnableAttackBlocking", Globals::enable_for_attacks);
-        Globals::enable_for_dodges = ini.GetBoolValue("General", "EnableDodgeBlocking", Globals::enable_for_dodges);
-        Globals::enable_for_slides = ini.GetBoolValue("General", "EnableSlideBlocking", Globals::enable_for_slides);
-
-        Globals::teleport = ini.GetBoolValue("Tweaks", "Teleport", Globals::teleport);
-        Globals::valid_safe_point_distance = static_cast<float>(ini.GetDoubleValue("Tweaks", "ValidSafePointDistance", Globals::valid_safe_point_distance));
-
-        Globals::drop_threshold = static_cast<float>(ini.GetDoubleValue("Tweaks", "DropThreshold", Globals::drop_threshold));
-        if (Globals::drop_threshold > 600.0f)
-            Globals::drop_threshold = 590.0f;
-        Globals::ledge_distance = static_cast<float>(ini.GetDoubleValue("Tweaks", "LedgeDistance", Globals::ledge_distance));
-        Globals::ground_leeway = static_cast<float>(ini.GetDoubleValue("Tweaks", "GroundLeeway", Globals::ground_leeway));
-        Globals::jump_duration = static_cast<float>(ini.GetDoubleValue("Tweaks", "JumpDuration", Globals::jump_duration));
-        Globals::memory_duration = ini.GetLongValue("Tweaks", "MemoryDuration", Globals::memory_duration);
-        Globals::memory_duration = std::max(Globals::memory_duration, 1);
+
+        Globals::adaptive_rays = ini.GetBoolValue("Performance", "AdaptiveRays", Globals::adaptive_rays);
+        Globals::sweep_probe = ini.GetBoolValue("Performance", "SweepProbe", Globals::sweep_probe);
+        Globals::two_phase_rays = ini.GetBoolValue("Performance", "TwoPhaseRays", Globals::two_phase_rays);
+        Globals::terrain_fast_path = ini.GetBoolValue("Performance", "TerrainFastPath", Globals::terrain_fast_path);
+        Globals::ledge_index = ini.GetBoolValue("Performance", "NavmeshLedgeIndex", Globals::ledge_index);
+        Globals::ledge_distance_field = ini.GetBoolValue("Performance", "LedgeDistanceField", Globals::ledge_distance_field);
+        Globals::baked_ledge_map = ini.GetBoolValue("Performance", "BakedLedgeMap", Globals::baked_ledge_map);
+        Globals::persistent_ledge_cache = ini.GetBoolValue("Performance", "PersistentLedgeCache", Globals::persistent_ledge_cache);
+        Globals::parallel_checks = ini.GetBoolValue("Performance", "ParallelChecks", Globals::parallel_checks);
+        Globals::worker_threads = ini.GetLongValue("Performance", "WorkerThreads", Globals::worker_threads);
+        Globals::worker_threads = std::clamp(Globals::worker_threads, 0, 16);
+        Globals::async_checks = ini.GetBoolValue("Performance", "AsyncChecks", Globals::async_checks);
+        Globals::post_physics_checks = ini.GetBoolValue("Performance", "PostPhysicsChecks", Globals::post_physics_checks);
+        Globals::global_animation_hook = ini.GetBoolValue("Performance", "GlobalAnimationHook", Globals::global_animation_hook);
+        Globals::frame_watchdog = ini.GetBoolValue("Performance", "FrameWatchdog", Globals::frame_watchdog);
+        Globals::distance_lod = ini.GetBoolValue("Performance", "DistanceLod", Globals::distance_lod);
+        Globals::rigid_body_cache = ini.GetBoolValue("Performance", "RigidBodyCache", Globals::rigid_body_cache);
+        if (Globals::ledge_distance_field && !Globals::ledge_index)
+        {
+            logger::warn("LedgeDistanceField needs NavmeshLedgeIndex, enabling it"sv);
+            Globals::ledge_index = true;
+        }
+        if (Globals::persistent_ledge_cache && !Globals::ledge_index)
+        {
+            logger::warn("PersistentLedgeCache needs NavmeshLedgeIndex, enabling it"sv);
+            Globals::ledge_index = true;
+        }
 
         Globals::log_level = ini.GetLongValue("Debug", "LoggingLevel", 2);
+        // Resolved here rather than in SetLogLevel, the probe kernel picked at the end needs it
+        if (Globals::log_level == 10)
+            Globals::show_markers = true;
+        Globals::watch_config = ini.GetBoolValue("Debug", "WatchConfig", Globals::watch_config);
+        Globals::record_replay = ini.GetBoolValue("Debug", "RecordReplay", Globals::record_replay);
 
         logger::debug("Version                  {}"sv, SKSE::PluginDeclaration::GetSingleton()->GetVersion());
         logger::debug("UseTogglePower:          {}"sv, Globals::use_spell_toggle);
 
-        logger::debug("DisableOnStairs          {}"sv, Globals::disable_on_stairs);
+        logger::debug("DisableOnStairs          {}"sv, snapshot.disable_on_stairs);
         logger::debug("EnableNPCs:              {}"sv, Globals::enable_for_npcs);
-        logger::debug("EnableAttackBlocking:    {}"sv, Globals::enable_for_attacks);
-        logger::debug("EnableDodgeBlocking:     {}"sv, Globals::enable_for_dodges);
-        logger::debug("EnableSlideBlocking:     {}"sv, Globals::enable_for_slides);
+        logger::debug("EnableAttackBlocking:    {}"sv, snapshot.enable_for_attacks);
+        logger::debug("EnableDodgeBlocking:     {}"sv, snapshot.enable_for_dodges);
+        logger::debug("EnableSlideBlocking:     {}"sv, snapshot.enable_for_slides);
+
+        logger::debug("Teleport:                {}"sv, snapshot.teleport);
+        logger::debug("ValidSafePointDistance:  {:.2f}"sv, snapshot.valid_safe_point_distance);
 
-        logger::debug("Teleport:                {}"sv, Globals::teleport);
-        logger::debug("ValidSafePointDistance:  {:.2f}"sv, Globals::valid_safe_point_distance);
+        logger::debug("DropThreshold:           {:.2f}"sv, snapshot.drop_threshold);
+        logger::debug("LedgeDistance:           {:.2f}"sv, snapshot.ledge_distance);
+        logger::debug("JumpDuration             {:.2f}"sv, snapshot.jump_duration);
+        logger::debug("GroundLeeway             {:.2f}"sv, snapshot.ground_leeway);
+        logger::debug("MemoryDuration:          {}"sv, snapshot.memory_duration);
 
-        logger::debug("DropThreshold:           {:.2f}"sv, Globals::drop_threshold);
-        logger::debug("LedgeDistance:           {:.2f}"sv, Globals::ledge_distance);
-        logger::debug("JumpDuration             {:.2f}"sv, Globals::jump_duration);
-        logger::debug("GroundLeeway             {:.2f}"sv, Globals::ground_leeway);
-        logger::debug("MemoryDuration:          {}"sv, Globals::memory_duration);
+        logger::debug("AdaptiveRays:            {}"sv, Globals::adaptive_rays);
+        logger::debug("RefineSteps:             {}"sv, snapshot.refine_steps);
+        logger::debug("SweepProbe:              {}"sv, Globals::sweep_probe);
+        logger::debug("TwoPhaseRays:            {}"sv, Globals::two_phase_rays);
+        logger::debug("TerrainFastPath:         {}"sv, Globals::terrain_fast_path);
+        logger::debug("NavmeshLedgeIndex:       {}"sv, Globals::ledge_index);
+        logger::debug("LedgeDistanceField:      {}"sv, Globals::ledge_distance_field);
+        logger::debug("BakedLedgeMap:           {}"sv, Globals::baked_ledge_map);
+        logger::debug("PersistentLedgeCache:    {}"sv, Globals::persistent_ledge_cache);
+        logger::debug("ParallelChecks:          {}"sv, Globals::parallel_checks);
+        logger::debug("WorkerThreads:           {}"sv, Globals::worker_threads);
+        logger::debug("AsyncChecks:             {}"sv, Globals::async_checks);
+        logger::debug("AsyncMaxStaleness:       {}"sv, snapshot.async_max_staleness);
+        logger::debug("PostPhysicsChecks:       {}"sv, Globals::post_physics_checks);
+        logger::debug("GlobalAnimationHook:     {}"sv, Globals::global_animation_hook);
+        logger::debug("FrameWatchdog:           {}"sv, Globals::frame_watchdog);
+        logger::debug("FrameBudget:             {:.2f}"sv, snapshot.frame_budget);
+        logger::debug("DistanceLod:             {}"sv, Globals::distance_lod);
+        logger::debug("LodNearDistance:         {:.2f}"sv, snapshot.lod_near_distance);
+        logger::debug("LodFarDistance:          {:.2f}"sv, snapshot.lod_far_distance);
+        logger::debug("RigidBodyCache:          {}"sv, Globals::rigid_body_cache);
 
         logger::debug("LoggingLevel:            {}"sv, Globals::log_level);
+        logger::debug("WatchConfig:             {}"sv, Globals::watch_config);
+        logger::debug("RecordReplay:            {}"sv, Globals::record_replay);
 
         ini.SetBoolValue("General", "UseTogglePower", Globals::use_spell_toggle,
                          "#If enabled, gives the player a power to toggle on/off ledge blocking.");
 
         const char *stairsComment = ("#Disable the ledge block while on stairs, this prevents rolling/attacking down stairs from being interfered with. Default true."
                                      "\n#Some stairs are not line of sight blocking (and therefore don't get hit by this mod's ray casts) and don't play well with this mod.");
-        ini.SetBoolValue("General", "DisableOnStairs", Globals::disable_on_stairs, stairsComment);
+        ini.SetBoolValue("General", "DisableOnStairs", snapshot.disable_on_stairs, stairsComment);
 
         ini.SetBoolValue("General", "EnableNPCs", Globals::enable_for_npcs, "#Enable ledge blocking for NPCs, default true.");
-        ini.SetBoolValue("General", "EnableAttackBlocking", Globals::enable_for_attacks, "#Enable ledge blocking for MCO/BFCO attacks");
-        ini.SetBoolValue("General", "EnableDodgeBlocking", Globals::enable_for_dodges, "#Enable ledge blocking for DMCO/TUDM/TK dodges");
-        ini.SetBoolValue("General", "EnableSlideBlocking", Globals::enable_for_slides, "#Enable ledge blocking for Crouch Slide");
+        ini.SetBoolValue("General", "EnableAttackBlocking", snapshot.enable_for_attacks, "#Enable ledge blocking for MCO/BFCO attacks");
+        ini.SetBoolValue("General", "EnableDodgeBlocking", snapshot.enable_for_dodges, "#Enable ledge blocking for DMCO/TUDM/TK dodges");
+        ini.SetBoolValue("General", "EnableSlideBlocking", snapshot.enable_for_slides, "#Enable ledge blocking for Crouch Slide");
 
         const char *teleportComment = ("#Teleports the actor back to the last place that they were not on a ledge. Disabling is not advised."
                                        "\n#Prevents very fast animations from breaking free from ledges. Default Enabled.");
-        ini.SetBoolValue("Tweaks", "Teleport", Globals::teleport, teleportComment);
+        ini.SetBoolValue("Tweaks", "Teleport", snapshot.teleport, teleportComment);
 
         const char *validSafePointComment = ("#If Teleport is enabled, when an actor is detected as on a ledge, this is how far a safe point can be from the actor and be a valid"
                                              "\n#teleport target. This prevents an actor from being teleported to a point on the ledge that is far from their current position. Default is 10.0");
-        ini.SetDoubleValue("Tweaks", "ValidSafePointDistance", static_cast<double>(Globals::valid_safe_point_distance), validSafePointComment);
+        ini.SetDoubleValue("Tweaks", "ValidSafePointDistance", static_cast<double>(snapshot.valid_safe_point_distance), validSafePointComment);
 
         const char *dropThresholdComment = ("#How far the raycast needs to go before it is considered a drop 150.0 = 1.5x default player height"
                                             "\n#Max of 600.0, ray casts of 600.0 are automatically considered as a ledge.");
-        ini.SetDoubleValue("Tweaks", "DropThreshold", static_cast<double>(Globals::drop_threshold), dropThresholdComment);
+        ini.SetDoubleValue("Tweaks", "DropThreshold", static_cast<double>(snapshot.drop_threshold), dropThresholdComment);
 
         const char *ledgeDistanceComment = ("#How far should a ledge be detected. Default 25.0");
-        ini.SetDoubleValue("Tweaks", "LedgeDistance", static_cast<double>(Globals::ledge_distance), ledgeDistanceComment);
+        ini.SetDoubleValue("Tweaks", "LedgeDistance", static_cast<double>(snapshot.ledge_distance), ledgeDistanceComment);
 
-        ini.SetDoubleValue("Tweaks", "JumpDuration", Globals::jump_duration,
+        ini.SetDoubleValue("Tweaks", "JumpDuration", snapshot.jump_duration,
                            "#How long after jumping should ledge blocker be disabled. Default is 1.5 seconds.");
-        ini.SetDoubleValue("Tweaks", "GroundLeeway", static_cast<double>(Globals::ground_leeway),
+        ini.SetDoubleValue("Tweaks", "GroundLeeway", static_cast<double>(snapshot.ground_leeway),
                            "#How far the player should be off the ground before ledge detection shuts off. Default 90.0");
 
         const char *memoryDurationComment = ("#This stops the ledge detection from cutting off too early and dropping the actor off a ledge."
                                              "\n#Each check is ~11 milliseconds apart, default remembers for 10 checks.");
-        ini.SetLongValue("Tweaks", "MemoryDuration", Globals::memory_duration, memoryDurationComment);
+        ini.SetLongValue("Tweaks", "MemoryDuration", snapshot.memory_duration, memoryDurationComment);
+
+        const char *adaptiveRaysComment = ("#Cast the same rays as the default ring and, only when one of them finds a drop, refine where it is"
+                                           "\n#(bisect the angle and distance of the drop). Same ledge decisions, more precise near ledges. Default false.");
+        ini.SetBoolValue("Performance", "AdaptiveRays", Globals::adaptive_rays, adaptiveRaysComment);
+        ini.SetLongValue("Performance", "RefineSteps", snapshot.refine_steps,
+                         "#How many bisection steps AdaptiveRays and SweepProbe spend on a found drop, 1 to 6. Default 3.");
+
+        const char *sweepProbeComment = ("#Add one slanted ray along the movement direction to the default ring's rays. It is stopped by ground less than"
+                                         "\n#DropThreshold lower, so a drop straight ahead that falls between the ring's rays is seen too. One ray more than the ring."
+                                         "\n#Takes priority over AdaptiveRays. Default false.");
+        ini.SetBoolValue("Performance", "SweepProbe", Globals::sweep_probe, sweepProbeComment);
+
+        const char *twoPhaseRaysComment = ("#Cast short rays (DropThreshold + GroundLeeway deep) first and only extend them to the full 600.0 units"
+                                           "\n#when the opposite direction's reference height needs it. Same ledge decisions, cheaper rays. Default false.");
+        ini.SetBoolValue("Performance", "TwoPhaseRays", Globals::two_phase_rays, twoPhaseRaysComment);
+
+        const char *terrainFastPathComment = ("#In exteriors, read the ground height from the land's height grid instead of casting a ray"
+                                              "\n#wherever no statics sit on the land. Default false.");
+        ini.SetBoolValue("Performance", "TerrainFastPath", Globals::terrain_fast_path, terrainFastPathComment);
+
+        const char *ledgeIndexComment = ("#When a cell loads, index its navmesh boundary edges that have a drop behind them, checked every LedgeDistance along the edge."
+                                         "\n#Ledge rays are then only cast near one of those edges. Cells without navmesh always use rays. Default false.");
+        ini.SetBoolValue("Performance", "NavmeshLedgeIndex", Globals::ledge_index, ledgeIndexComment);
+
+        const char *distanceFieldComment = ("#Turn each cell's navmesh ledge index into a distance-to-nearest-ledge grid (8 units per sample) on a background thread."
+                                            "\n#Ledge rays are then gated by a single grid lookup. Needs NavmeshLedgeIndex. Default false.");
+        ini.SetBoolValue("Performance", "LedgeDistanceField", Globals::ledge_distance_field, distanceFieldComment);
+
+        const char *bakedLedgeMapComment = ("#Use AnimationLedgeBlockNG.ledgemap (made with the ledgebake tool) next to this file. Cells in it"
+                                            "\n#skip the runtime navmesh index and only cast rays near a baked ledge. Default false.");
+        ini.SetBoolValue("Performance", "BakedLedgeMap", Globals::baked_ledge_map, bakedLedgeMapComment);
+
+        const char *ledgeCacheComment = ("#Keep the navmesh ledge index in AnimationLedgeBlockNG.ledgecache next to this file so visited cells"
+                                         "\n#start warm next session. Rebuilt when the load order, DropThreshold or LedgeDistance changes. Needs NavmeshLedgeIndex. Default false.");
+        ini.SetBoolValue("Performance", "PersistentLedgeCache", Globals::persistent_ledge_cache, ledgeCacheComment);
+
+        const char *parallelChecksComment = ("#Run the ledge checks of different actors on worker threads while the physics world is read locked."
+                                             "\n#Teleports and debug markers are applied on the main thread afterwards. Helps large battles on many-core CPUs. Default false.");
+        ini.SetBoolValue("Performance", "ParallelChecks", Globals::parallel_checks, parallelChecksComment);
+        ini.SetLongValue("Performance", "WorkerThreads", Globals::worker_threads,
+                         "#Worker threads for ParallelChecks, 0 picks one per spare core up to 7. Default 0.");
+
+        const char *asyncChecksComment = ("#Cast the ledge rays on a background thread and apply the result on the next check, one check late."
+                                          "\n#Moves most of the ray cost off the game thread. Takes priority over ParallelChecks. Default false.");
+        ini.SetBoolValue("Performance", "AsyncChecks", Globals::async_checks, asyncChecksComment);
+        ini.SetLongValue("Performance", "AsyncMaxStaleness", snapshot.async_max_staleness,
+                         "#Milliseconds an AsyncChecks result may be old before the check runs on the game thread instead, 11 to 1000. Default 50.");
+
+        const char *postPhysicsChecksComment = ("#Run the due ledge checks right after the physics world steps instead of during the player update."
+                                                "\n#Positions are final for the frame and the physics data is still in cache. Needs a game restart. Default false.");
+        ini.SetBoolValue("Performance", "PostPhysicsChecks", Globals::post_physics_checks, postPhysicsChecksComment);
+
+        const char *globalAnimationHookComment = ("#Receive animation events through one hook on every character instead of registering an event sink"
+                                                  "\n#on each tracked actor's animation graph. Untracked actors are skipped with a single lookup, tracked actors' events are applied"
+                                                  "\n#on the main thread, up to a frame later. Needs a game restart. Default false.");
+        ini.SetBoolValue("Performance", "GlobalAnimationHook", Globals::global_animation_hook, globalAnimationHookComment);
+
+        const char *frameWatchdogComment = ("#Measure the plugin's share of each frame and, while it is over FrameBudget, step down through cheaper checks:"
+                                            "\n#fewer rays, NPCs checked half as often, player only, rays only near cached ledges. Steps back up with headroom. Default false.");
+        ini.SetBoolValue("Performance", "FrameWatchdog", Globals::frame_watchdog, frameWatchdogComment);
+        ini.SetDoubleValue("Performance", "FrameBudget", static_cast<double>(snapshot.frame_budget),
+                           "#Percent of the frame time FrameWatchdog allows the ledge checks, 0.5 to 50.0. Default 2.0.");
+
+        const char *distanceLodComment = ("#Check NPCs beyond LodNearDistance from the camera every other tick with fewer rays, and those beyond LodFarDistance"
+                                          "\n#every fourth tick and only near cached ledges. Off-screen NPCs count one step farther. The first check after an NPC"
+                                          "\n#starts a dodge or attack is a full one on the next tick, the rest of the move follows these steps. Default false.");
+        ini.SetBoolValue("Performance", "DistanceLod", Globals::distance_lod, distanceLodComment);
+        ini.SetDoubleValue("Performance", "LodNearDistance", static_cast<double>(snapshot.lod_near_distance),
+                           "#Camera distance where DistanceLod starts reducing NPC checks. Default 1500.0");
+        ini.SetDoubleValue("Performance", "LodFarDistance", static_cast<double>(snapshot.lod_far_distance),
+                           "#Camera distance where DistanceLod only checks NPCs near cached ledges. Default 4000.0");
+
+        const char *rigidBodyCacheComment = ("#Remember per collision body whether a ray hit a tree, plant or actor instead of looking up its reference"
+                                             "\n#and base object on every hit. Forgotten whenever a reference unloads. Helps in forests. Default false.");
+        ini.SetBoolValue("Performance", "RigidBodyCache", Globals::rigid_body_cache, rigidBodyCacheComment);
 
         ini.SetLongValue("Debug", "LoggingLevel", Globals::log_level,
                          "#0: Errors, 1: Warnings, 2: Info (default), 3: Debug, 4: Trace, 10: Trace + Markers");
 
-        ini.SaveFile("Data\\SKSE\\Plugins\\AnimationLedgeBlockNG.ini");
+        const char *watchConfigComment = ("#Re-read this file whenever it is saved while the game runs. Only the [General] blocking toggles, [Tweaks]"
+                                          "\n#and RefineSteps/AsyncMaxStaleness/FrameBudget/Lod*Distance take effect without a restart. Default false.");
+        ini.SetBoolValue("Debug", "WatchConfig", Globals::watch_config, watchConfigComment);
+
+        const char *recordReplayComment = ("#Record every check tick (actor motion, animation state, each ledge ray and the decision) to"
+                                           "\n#AnimationLedgeBlockNG.replay next to the log, for bug reports. About a few KB per second in combat. Default false.");
+        ini.SetBoolValue("Debug", "RecordReplay", Globals::record_replay, recordReplayComment);
+
+        ini.SaveFile(iniPath);
+
+        Publish(snapshot);
+        Utils::SelectProbeKernel();
+    }
+
+    void Reload()
+    {
+        CSimpleIniA ini;
+        ini.SetUnicode();
+        if (ini.LoadFile(iniPath) < 0)
+        {
+            logger::warn("Could not reload AnimationLedgeBlockNG.ini, keeping the current values"sv);
+            return;
+        }
+        Snapshot snapshot;
+        ReadSnapshot(ini, snapshot);
+        Publish(snapshot);
+        logger::info("Reloaded AnimationLedgeBlockNG.ini: DropThreshold {:.2f}, LedgeDistance {:.2f}, GroundLeeway {:.2f}"sv,
+                     snapshot.drop_threshold, snapshot.ledge_distance, snapshot.ground_leeway);
+    }
+
+    void WatchFile()
+    {
+        if (g_watcher.joinable())
+            return;
+        g_watcher = std::jthread([](std::stop_token stop_token) {
+            std::error_code error;
+            auto last_write = std::filesystem::last_write_time(iniPath, error);
+            std::mutex sleep_lock;
+            std::condition_variable_any sleep_signal;
+            while (true)
+            {
+                std::unique_lock lock(sleep_lock);
+                sleep_signal.wait_for(lock, stop_token, std::chrono::seconds(1), [] { return false; });
+                if (stop_token.stop_requested())
+                    return;
+                const auto write = std::filesystem::last_write_time(iniPath, error);
+                if (error || write == last_write)
+                    continue;
+                last_write = write;
+                Reload();
+            }
+        });
     }
 }
\ No newline at end of file
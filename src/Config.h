@@ -2,9 +2,49 @@
 
 namespace Config
 {
+    // Tuning values that can change while the game runs. A published snapshot is never modified, a check
+    // acquires the current one once and sees a consistent set throughout.
+    struct Snapshot
+    {
+        bool disable_on_stairs = true;
+        bool enable_for_attacks = true;
+        bool enable_for_dodges = true;
+        bool enable_for_slides = true;
+        bool teleport = true;
+        float valid_safe_point_distance = 10.0f;
+        float drop_threshold = 150.0f; // 1.5x 1.0 player height
+        float ledge_distance = 25.0f;  // 25.0 units around the player
+        float ground_leeway = 90.0f;
+        int memory_duration = 10;
+        float jump_duration = 1.5f;
+        int refine_steps = 3;
+        int async_max_staleness = 50;
+        float frame_budget = 2.0f; // Percent of the frame the watchdog allows the plugin
+        float lod_near_distance = 1500.0f; // Camera distances where NPC checks get cheaper
+        float lod_far_distance = 4000.0f;
+
+        // Derived when published
+        float ledge_reach = 0.0f;           // Rays are only cast this close to a known ledge
+        float field_margin = 0.0f;          // How far a distance field reaches past its edges
+        LedgeProbes::Params probes;         // The probe tuning above, with the two-phase lengths
+    };
+
+    // The latest published snapshot, LoadConfig publishes the first one. The reference stays valid for
+    // a grace period after the next publish, enough for one event or tick.
+    const Snapshot &Current();
+
+    // The latest published snapshot, for a check that outlives the tick it started in.
+    std::shared_ptr<const Snapshot> Acquire();
+
     void SetUpLog();
 
     void SetLogLevel();
 
     void LoadConfig();
+
+    // Re-reads the tuning values from the ini and publishes them. Everything else needs a restart.
+    void Reload();
+
+    // Reloads whenever the ini's modification time changes, polled on a background thread.
+    void WatchFile();
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+namespace DistanceField
+{
+    constexpr float base_spacing = 8.0f;       // Units between samples
+    constexpr int max_samples_per_axis = 1024; // Larger interiors get a coarser spacing
+
+    struct Field
+    {
+        RE::FormID cell_id = 0;
+        const void *space = nullptr;
+        std::uint32_t generation = 0;
+        LedgeMap::Field field;
+    };
+
+    struct Job
+    {
+        RE::FormID cell_id;
+        const void *space;
+        std::uint32_t generation;
+        float margin;
+        std::vector<LedgeMap::Edge> edges;
+    };
+
+    // Main thread only
+    std::unordered_map<RE::FormID, Field> g_fields;
+    std::unordered_map<RE::FormID, std::uint32_t> g_generations;
+    std::unordered_set<RE::FormID> g_pending;
+
+    // Shared with the worker
+    std::mutex g_queue_lock;
+    std::condition_variable_any g_queue_signal;
+    std::deque<Job> g_jobs;
+    std::vector<Field> g_finished;
+    std::jthread g_worker;
+
+    void WorkerLoop(std::stop_token stop_token)
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(g_queue_lock);
+                if (!g_queue_signal.wait(lock, stop_token, [] { return !g_jobs.empty(); }))
+                    return;
+                job = std::move(g_jobs.front());
+                g_jobs.pop_front();
+            }
+            Field field{job.cell_id, job.space, job.generation,
+                        LedgeMap::BuildDistanceField(job.edges, job.margin, base_spacing, max_samples_per_axis)};
+            std::scoped_lock lock(g_queue_lock);
+            g_finished.push_back(std::move(field));
+        }
+    }
+
+    void EnsureField(RE::TESObjectCELL *cell)
+    {
+        if (!cell)
+            return;
+        const auto cell_id = cell->GetFormID();
+        if (g_fields.contains(cell_id) || g_pending.contains(cell_id))
+            return;
+        const auto *edges = LedgeIndex::GetEdges(cell);
+        if (!edges)
+            return;
+
+        Job job{cell_id, LedgeIndex::GetSpace(cell), g_generations[cell_id], Config::Current().field_margin, {}};
+        job.edges.reserve(edges->size());
+        for (const auto &edge : *edges)
+            job.edges.push_back({edge.start.x, edge.start.y, edge.start.z, edge.end.x, edge.end.y, edge.end.z});
+        g_pending.insert(cell_id);
+        {
+            std::scoped_lock lock(g_queue_lock);
+            g_jobs.push_back(std::move(job));
+            if (!g_worker.joinable())
+                g_worker = std::jthread(WorkerLoop);
+        }
+        g_queue_signal.notify_one();
+    }
+
+    void Invalidate(RE::TESObjectCELL *cell)
+    {
+        if (!cell)
+            return;
+        const auto cell_id = cell->GetFormID();
+        ++g_generations[cell_id];
+        g_fields.erase(cell_id);
+        g_pending.erase(cell_id);
+    }
+
+    void CollectFinished()
+    {
+        std::vector<Field> finished;
+        {
+            std::unique_lock lock(g_queue_lock, std::try_to_lock);
+            if (!lock.owns_lock() || g_finished.empty())
+                return;
+            finished.swap(g_finished);
+        }
+        for (auto &field : finished)
+        {
+            // Stale if the cell was reloaded or evicted while the worker was busy
+            if (!g_pending.contains(field.cell_id) || g_generations[field.cell_id] != field.generation)
+                continue;
+            g_pending.erase(field.cell_id);
+            logger::debug("Built {}x{} ledge distance field for cell {:X}"sv, field.field.width, field.field.height, field.cell_id);
+            g_fields[field.cell_id] = std::move(field);
+        }
+    }
+
+    void EvictDetachedCells()
+    {
+        const auto is_detached = [](RE::FormID cell_id) {
+            const auto cell = RE::TESForm::LookupByID<RE::TESObjectCELL>(cell_id);
+            return !cell || !cell->IsAttached();
+        };
+        for (auto it = g_fields.begin(); it != g_fields.end();)
+        {
+            if (is_detached(it->first))
+            {
+                ++g_generations[it->first];
+                it = g_fields.erase(it);
+            }
+            else
+                ++it;
+        }
+        for (auto it = g_pending.begin(); it != g_pending.end();)
+        {
+            if (is_detached(*it))
+            {
+                ++g_generations[*it];
+                it = g_pending.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    bool HasField(RE::TESObjectCELL *cell)
+    {
+        return cell && g_fields.contains(cell->GetFormID());
+    }
+
+    float DistanceToNearestLedge(RE::TESObjectCELL *cell, const RE::NiPoint3 &pos, float max_distance)
+    {
+        if (!cell)
+            return max_distance;
+        const void *space = LedgeIndex::GetSpace(cell);
+        float best = max_distance;
+        for (const auto &[cell_id, field] : g_fields)
+        {
+            if (field.space == space)
+                best = LedgeMap::SampleDistance(field.field.View(), pos.x, pos.y, best);
+        }
+        return LedgeIndex::DistanceToNearestLedge(cell, pos, best, [](RE::FormID cell_id) { return g_fields.contains(cell_id); });
+    }
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace DistanceField
+{
+    // Queues a background build of the cell's field from its navmesh ledge index, if it has neither yet.
+    void EnsureField(RE::TESObjectCELL *cell);
+
+    // Drops the cell's field, it is rebuilt lazily from the cell's current ledge index.
+    void Invalidate(RE::TESObjectCELL *cell);
+
+    // Moves the fields the worker finished into the lookup table, call from the main thread.
+    void CollectFinished();
+
+    void EvictDetachedCells();
+
+    bool HasField(RE::TESObjectCELL *cell);
+
+    // Distance from pos to the nearest ledge edge in the same interior or worldspace,
+    // max_distance if there is none closer. Cells whose field isn't built yet are asked through
+    // their ledge index, so ledges across a cell border count before the neighbour's field is done.
+    float DistanceToNearestLedge(RE::TESObjectCELL *cell, const RE::NiPoint3 &pos, float max_distance);
+}
\ No newline at end of file
@@ -18,15 +18,20 @@ namespace Events
         }
         auto formID = actor->GetFormID();
         auto combatState = a_event->newState;
-        if (combatState == RE::ACTOR_COMBAT_STATE::kCombat && !Globals::g_actor_states.contains(formID))
+        const auto combat = combatState == RE::ACTOR_COMBAT_STATE::kCombat ? Tracking::CombatState::kCombat
+                            : combatState == RE::ACTOR_COMBAT_STATE::kNone ? Tracking::CombatState::kNone
+                                                                            : Tracking::CombatState::kSearching;
+        const auto change = Tracking::OnCombatEvent(Globals::g_actor_states.contains(formID), combat);
+        if (change == Tracking::CombatChange::kTrack)
         {
-            auto &state = Globals::g_actor_states[formID];
+            auto &state = Globals::TrackActor(formID);
             if (state.ray_markers.empty() && Globals::show_markers)
                 Objects::InitializeRayMarkers(actor);
-            actor->AddAnimationGraphEventSink(AttackAnimationGraphEventSink::GetSingleton());
+            if (!Globals::global_animation_hook)
+                actor->AddAnimationGraphEventSink(AttackAnimationGraphEventSink::GetSingleton());
             logger::debug("Tracking new combat actor: {}"sv, actor->GetName());
         }
-        else if (combatState == RE::ACTOR_COMBAT_STATE::kNone && Globals::g_actor_states.contains(formID))
+        else if (change == Tracking::CombatChange::kUntrack)
         {
             auto it = Globals::g_actor_states.find(formID);
             if (it != Globals::g_actor_states.end())
@@ -39,12 +44,13 @@ namespace Events
                         it->second.ledge_blocker->GetPositionY(),
                         -10000.0f);
                 }
-                Globals::g_actor_states.erase(it);
-                actor->RemoveAnimationGraphEventSink(AttackAnimationGraphEventSink::GetSingleton());
+                Globals::UntrackActor(it);
+                if (!Globals::global_animation_hook)
+                    actor->RemoveAnimationGraphEventSink(AttackAnimationGraphEventSink::GetSingleton());
                 logger::debug("Stopped tracking actor: {}"sv, actor->GetName());
             }
         }
-        Utils::CleanupActors();
+        // Other actors that died or vanished without an event go in the periodic CleanupActors
         return RE::BSEventNotifyControl::kContinue;
     }
     CombatEventSink *CombatEventSink::GetSingleton()
@@ -53,40 +59,6 @@ namespace Events
         return &singleton;
     }
 
-    bool IsAnimationStart(const RE::BSFixedString tag)
-    {
-        if (Globals::enable_for_attacks && tag == "PowerAttack_Start_end")
-            return true;
-        if (Globals::enable_for_dodges && (tag == "MCO_DodgeInitiate" ||
-                                           tag == "RollTrigger" || tag == "SidestepTrigger" ||
-                                           tag == "TKDR_DodgeStart" || tag == "MCO_DisableSecondDodge"))
-            return true;
-        if (Globals::enable_for_slides && tag == "SlideStart")
-            return true;
-        return false;
-    }
-
-    bool IsAnimationEnd(Globals::ActorState state, const RE::BSFixedString tag, const RE::BSFixedString payload)
-    {
-        if (!state.is_attacking)
-            return false;
-        if ((state.animation_type == 1 && tag == "attackStop") ||
-            (state.animation_type == 2 && payload == "$DMCO_Reset") ||
-            (state.animation_type == 3 && tag == "RollStop") ||
-            (state.animation_type == 4 && tag == "TKDR_DodgeEnd") ||
-            (state.animation_type == 5 && tag == "EnableBumper") ||
-            (state.animation_type == 6 && tag == "SlideStop") ||
-            state.animation_type == 0)
-            return true;
-        if (state.animation_type != 1 && state.animation_type != 4 && tag == "InterruptCast")
-            return true;
-        if (state.animation_type != 4 && tag == "IdleStop")
-            return true;
-        if (tag == "JumpUp" || tag == "MTstate")
-            return true;
-        return false;
-    }
-
     RE::BSEventNotifyControl AttackAnimationGraphEventSink::ProcessEvent(
         const RE::BSAnimationGraphEvent *event,
         RE::BSTEventSource<RE::BSAnimationGraphEvent> *)
@@ -100,47 +72,29 @@ namespace Events
         if (!actor)
             return RE::BSEventNotifyControl::kContinue;
 
-        const char *holder_name = event->holder->GetName();
+        ApplyEvent(actor, event->tag.c_str(), event->payload.c_str());
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    void AttackAnimationGraphEventSink::ApplyEvent(RE::Actor *actor, std::string_view tag, std::string_view payload)
+    {
         Globals::ActorState *stateCheck = Globals::CheckState(actor);
         if (!stateCheck)
-            return RE::BSEventNotifyControl::kContinue;
+            return;
         Globals::ActorState &state = Globals::GetState(actor);
-        const RE::BSFixedString tag = event->tag;
-        const RE::BSFixedString payload = event->payload;
-        logger::trace("{} Payload: {}"sv, holder_name, payload.c_str());
-        logger::trace("{} Tag: {}"sv, holder_name, tag.c_str());
-        if (IsAnimationStart(tag))
+        const char *holder_name = actor->GetName();
+        logger::trace("{} Payload: {}"sv, holder_name, payload);
+        logger::trace("{} Tag: {}"sv, holder_name, tag);
+        const auto &config = Config::Current();
+        const AnimationTags::Toggles toggles{config.enable_for_attacks, config.enable_for_dodges, config.enable_for_slides};
+        const auto change = Tracking::OnAnimationEvent(state, tag, payload, toggles, static_cast<int>(clock()));
+        if (change == Tracking::AnimationChange::kStarted)
         {
-            state.is_attacking = true;
+            state.lod_promote = true;
             logger::debug("Animation Started for {}"sv, holder_name);
-            state.safe_grounded_positions.clear();
-            if (tag == "PowerAttack_Start_end") // Any Attack
-                state.animation_type = 1;
-            else if (tag == "MCO_DodgeInitiate") // DMCO
-                state.animation_type = 2;
-            else if (tag == "RollTrigger" || tag == "SidestepTrigger") // TUDMR
-                state.animation_type = 3;
-            else if (tag == "TKDR_DodgeStart") // TK Dodge RE
-                state.animation_type = 4;
-            else if (tag == "MCO_DisableSecondDodge") // Old DMCO
-                state.animation_type = 5;
-            else if (tag == "SlideStart") // Crouch Sliding
-                state.animation_type = 6;
         }
-        else if (IsAnimationEnd(state, tag, payload))
-        {
-            state.animation_type = 0;
-            state.is_attacking = false;
-            state.is_on_ledge = false;
+        else if (change == Tracking::AnimationChange::kEnded)
             logger::debug("Animation Finished for {}"sv, holder_name);
-        }
-        else if (!state.is_attacking && tag == "JumpUp")
-        {
-            state.jump_start = clock();
-            state.is_jumping = true;
-        }
-
-        return RE::BSEventNotifyControl::kContinue;
     }
 
     AttackAnimationGraphEventSink *AttackAnimationGraphEventSink::GetSingleton()
@@ -149,4 +103,24 @@ namespace Events
         return &singleton;
     }
 
+    RE::BSEventNotifyControl CellLoadEventSink::ProcessEvent(
+        const RE::TESCellFullyLoadedEvent *a_event,
+        RE::BSTEventSource<RE::TESCellFullyLoadedEvent> *)
+    {
+        if (!a_event || !a_event->cell)
+            return RE::BSEventNotifyControl::kContinue;
+        if (Globals::terrain_fast_path)
+            Terrain::BuildGrid(a_event->cell);
+        if (Globals::ledge_index)
+            LedgeIndex::BuildIndex(a_event->cell);
+        if (Globals::ledge_distance_field)
+            DistanceField::Invalidate(a_event->cell);
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    CellLoadEventSink *CellLoadEventSink::GetSingleton()
+    {
+        static CellLoadEventSink singleton;
+        return &singleton;
+    }
 }
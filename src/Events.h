@@ -19,5 +19,17 @@ namespace Events
             const RE::BSAnimationGraphEvent *event,
             RE::BSTEventSource<RE::BSAnimationGraphEvent> *) override;
         static AttackAnimationGraphEventSink *GetSingleton();
+
+        // Applies a tracked actor's animation event to its state, main thread only.
+        static void ApplyEvent(RE::Actor *actor, std::string_view tag, std::string_view payload);
+    };
+
+    class CellLoadEventSink final : public RE::BSTEventSink<RE::TESCellFullyLoadedEvent>
+    {
+    public:
+        RE::BSEventNotifyControl ProcessEvent(
+            const RE::TESCellFullyLoadedEvent *a_event,
+            RE::BSTEventSource<RE::TESCellFullyLoadedEvent> *) override;
+        static CellLoadEventSink *GetSingleton();
     };
 }
\ No newline at end of file
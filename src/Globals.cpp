@@ -2,19 +2,63 @@ namespace Globals
 {
     bool show_markers = false;
     int log_level = 2;
-    bool teleport = true;
-    float valid_safe_point_distance = 10.0f;
     bool enable_for_npcs = true;
-    bool disable_on_stairs = true;
-    bool enable_for_attacks = true;
-    bool enable_for_dodges = true;
-    bool enable_for_slides = true;
     bool use_spell_toggle = false;
-    float drop_threshold = 150.0f; // 1.5x 1.0 player height
-    float ledge_distance = 25.0f;  // 25.0 units around the player
-    float ground_leeway = 90.0f;
-    int memory_duration = 10;
-    float jump_duration = 1.5f;
+    bool adaptive_rays = false;
+    bool sweep_probe = false;
+    bool two_phase_rays = false;
+    bool terrain_fast_path = false;
+    bool ledge_index = false;
+    bool ledge_distance_field = false;
+    bool baked_ledge_map = false;
+    bool persistent_ledge_cache = false;
+    bool parallel_checks = false;
+    int worker_threads = 0;
+    bool async_checks = false;
+    bool post_physics_checks = false;
+    bool global_animation_hook = false;
+    bool frame_watchdog = false;
+    bool distance_lod = false;
+    bool rigid_body_cache = false;
+    bool record_replay = false;
+    bool watch_config = false;
+
+    // Copy of g_actor_states' keys for the animation threads
+    std::shared_mutex g_tracked_lock;
+    std::unordered_set<RE::FormID> g_tracked;
+
+    ActorState &TrackActor(RE::FormID form_id)
+    {
+        {
+            std::unique_lock lock(g_tracked_lock);
+            g_tracked.insert(form_id);
+        }
+        return g_actor_states[form_id];
+    }
+
+    std::unordered_map<RE::FormID, ActorState>::iterator UntrackActor(std::unordered_map<RE::FormID, ActorState>::iterator it)
+    {
+        {
+            std::unique_lock lock(g_tracked_lock);
+            g_tracked.erase(it->first);
+        }
+        return g_actor_states.erase(it);
+    }
+
+    void UntrackAll()
+    {
+        {
+            std::unique_lock lock(g_tracked_lock);
+            g_tracked.clear();
+        }
+        g_actor_states.clear();
+    }
+
+    bool IsTracked(RE::FormID form_id)
+    {
+        std::shared_lock lock(g_tracked_lock);
+        return g_tracked.contains(form_id);
+    }
 
     ActorState &GetState(RE::Actor *actor)
     {
@@ -4,21 +4,28 @@ namespace Globals
 {
     extern bool show_markers;
     extern int log_level;
-    extern bool teleport;
-    extern float valid_safe_point_distance;
     extern bool enable_for_npcs;
-    extern bool disable_on_stairs;
-    extern bool enable_for_attacks;
-    extern bool enable_for_dodges;
-    extern bool enable_for_slides;
     extern bool use_spell_toggle;
-    extern float drop_threshold;
-    extern float ledge_distance;
-    extern float ground_leeway;
-    extern int memory_duration;
-    extern float jump_duration;
+    extern bool adaptive_rays;
+    extern bool sweep_probe;
+    extern bool two_phase_rays;
+    extern bool terrain_fast_path;
+    extern bool ledge_index;
+    extern bool ledge_distance_field;
+    extern bool baked_ledge_map;
+    extern bool persistent_ledge_cache;
+    extern bool parallel_checks;
+    extern int worker_threads;
+    extern bool async_checks;
+    extern bool post_physics_checks;
+    extern bool global_animation_hook;
+    extern bool frame_watchdog;
+    extern bool distance_lod;
+    extern bool rigid_body_cache;
+    extern bool record_replay;
+    extern bool watch_config;
 
-    extern constexpr int num_rays = 12; // Number of rays to create.
+    extern constexpr int num_rays = LedgeProbes::num_rays; // Number of rays to create.
     extern constexpr int ray_marker_count = num_rays * 2;
 
     struct ActorState
@@ -29,14 +36,23 @@ namespace Globals
         bool is_looping = false;
 
         float best_yaw = 0.0f;
+        float ledge_lip_distance = 0.0f;
 
         int animation_type = 0;
 
+        int lod_tier = 0;          // ActorLod::Tier of the last check
+        int lod_wait = 0;          // Ticks left until the next check is due
+        bool lod_promote = false;  // A move just started, its first check is due at once and in full
+
         int jump_start = 0;
         bool is_jumping = false;
 
         RE::TESObjectCELL *last_actor_cell;
 
+        // Collision filter of the actor's ledge rays, rebuilt when the actor's own filter info changes
+        RE::CFilter pick_filter;
+        std::uint32_t pick_filter_info = 0;
+
         RE::TESObjectREFR *ledge_blocker;
 
         std::vector<RE::TESObjectREFR *> ray_markers;
@@ -46,6 +62,16 @@ namespace Globals
 
     inline std::unordered_map<RE::FormID, ActorState> g_actor_states;
 
+    // Adds and removes states, main thread only. Keeps the set IsTracked reads in step.
+    ActorState &TrackActor(RE::FormID form_id);
+
+    std::unordered_map<RE::FormID, ActorState>::iterator UntrackActor(std::unordered_map<RE::FormID, ActorState>::iterator it);
+
+    void UntrackAll();
+
+    // Whether the actor has a state, safe from any thread.
+    bool IsTracked(RE::FormID form_id);
+
     ActorState &GetState(RE::Actor *actor);
 
     ActorState *CheckState(RE::Actor *actor);
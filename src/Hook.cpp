@@ -16,9 +16,35 @@ namespace Hook
         playerUpdateManager->Install();
         logger::info("  >Installing Motion Update Hook..."sv);
         MotionUpdateHook::InstallHook();
+        if (Globals::post_physics_checks)
+        {
+            logger::info("  >Installing Physics Step listener..."sv);
+            PhysicsStepListener::Install();
+        }
+        if (Globals::global_animation_hook)
+        {
+            logger::info("  >Installing Animation Event Hook..."sv);
+            AnimationEventHook::Install();
+        }
         return true;
     }
 
+    void RunChecks()
+    {
+        if (Globals::use_spell_toggle && Utils::PlayerHasDeactivatorSpell())
+            return;
+        if (!Globals::frame_watchdog)
+            Utils::CheckAllActorsForLedges();
+        else
+        {
+            const auto start = std::chrono::steady_clock::now();
+            Utils::CheckAllActorsForLedges();
+            Watchdog::AddCost(std::chrono::steady_clock::now() - start);
+        }
+        if (Globals::record_replay)
+            Recorder::EndTick();
+    }
+
     void PlayerUpdateListener::Install()
     {
         REL::Relocation<std::uintptr_t> VTABLE{RE::PlayerCharacter::VTABLE[0]};
@@ -34,18 +60,94 @@ namespace Hook
         if (internalCounter >= timeBetweenChecks)
         {
             internalCounter = 0.0f;
-            if (!Globals::use_spell_toggle || !Utils::PlayerHasDeactivatorSpell())
-                Utils::CheckAllActorsForLedges();
+            if (Globals::post_physics_checks)
+            {
+                // The world didn't step since the last due checks, run them here rather than skip them
+                if (PhysicsStepListener::checksDue)
+                    RunChecks();
+                PhysicsStepListener::checksDue = true;
+            }
+            else
+                RunChecks();
         }
         if (internalCleanCounter >= timeBetweenCleaning)
         {
             internalCleanCounter = 0.0f;
             Utils::CleanupActors();
+            if (Globals::async_checks)
+                AsyncProbes::Prune();
+            if (Globals::terrain_fast_path)
+                Terrain::EvictDetachedCells();
+            if (Globals::ledge_index)
+                LedgeIndex::EvictDetachedCells();
+            if (Globals::ledge_distance_field)
+                DistanceField::EvictDetachedCells();
         }
+        if (Globals::frame_watchdog)
+            Watchdog::EndFrame(a_delta);
         internalCounter = std::clamp(internalCounter, 0.0f, timeBetweenChecks);
         internalCleanCounter = std::clamp(internalCleanCounter, 0.0f, timeBetweenCleaning);
     }
 
+    void PhysicsStepListener::Install()
+    {
+        REL::Relocation<std::uintptr_t> VTABLE{RE::bhkWorld::VTABLE[0]};
+        _func = VTABLE.write_vfunc(idx, Thunk);
+        return;
+    }
+
+    inline void PhysicsStepListener::Thunk(RE::bhkWorld *a_this, std::uint32_t a_updateFlags)
+    {
+        _func(a_this, a_updateFlags);
+        if (!checksDue)
+            return;
+        // Other loaded worlds step too, only the player's one matters
+        auto *player = RE::PlayerCharacter::GetSingleton();
+        auto *cell = player ? player->GetParentCell() : nullptr;
+        if (!cell || cell->GetbhkWorld() != a_this)
+            return;
+        checksDue = false;
+        RunChecks();
+    }
+
+    // The characters' animation graph event sink is their third vtable
+    void AnimationEventHook::Install()
+    {
+        REL::Relocation<std::uintptr_t> characterVtable{RE::VTABLE_Character[2]};
+        _characterFunc = characterVtable.write_vfunc(idx, CharacterThunk);
+        REL::Relocation<std::uintptr_t> playerVtable{RE::VTABLE_PlayerCharacter[2]};
+        _playerFunc = playerVtable.write_vfunc(idx, PlayerThunk);
+    }
+
+    RE::BSEventNotifyControl AnimationEventHook::CharacterThunk(RE::BSTEventSink<RE::BSAnimationGraphEvent> *a_sink, RE::BSAnimationGraphEvent *a_event,
+                                                                RE::BSTEventSource<RE::BSAnimationGraphEvent> *a_source)
+    {
+        Forward(a_event);
+        return _characterFunc(a_sink, a_event, a_source);
+    }
+
+    RE::BSEventNotifyControl AnimationEventHook::PlayerThunk(RE::BSTEventSink<RE::BSAnimationGraphEvent> *a_sink, RE::BSAnimationGraphEvent *a_event,
+                                                             RE::BSTEventSource<RE::BSAnimationGraphEvent> *a_source)
+    {
+        Forward(a_event);
+        return _playerFunc(a_sink, a_event, a_source);
+    }
+
+    void AnimationEventHook::Forward(RE::BSAnimationGraphEvent *a_event)
+    {
+        // Most events are footsteps and the like, the tag filter drops them before the tracked lookup
+        if (!a_event || !a_event->holder || !AnimationTags::IsRelevant(a_event->tag.c_str(), a_event->payload.c_str()) ||
+            !Globals::IsTracked(a_event->holder->GetFormID()))
+            return;
+        // Animation threads send these, the actor states belong to the main thread: the event is
+        // applied there, to the actor if it is still tracked by then
+        SKSE::GetTaskInterface()->AddTask([form_id = a_event->holder->GetFormID(), tag = std::string(a_event->tag.c_str()),
+                                           payload = std::string(a_event->payload.c_str())] {
+            if (auto *actor = RE::TESForm::LookupByID<RE::Actor>(form_id); actor)
+                Events::AttackAnimationGraphEventSink::ApplyEvent(actor, tag, payload);
+        });
+    }
+
     // target and offset from https://github.com/VanCZ1/Block-Cancel-Fix/blob/main/src/Hooks.cpp
     void MotionUpdateHook::InstallHook()
     {
@@ -71,7 +173,8 @@ namespace Hook
         if (stateCheck)
         {
             Globals::ActorState &state = Globals::GetState(a_character);
-            if (state.is_on_ledge)
+            // A ledge found by an asynchronous probe stops the actor before the tick applies it
+            if (state.is_on_ledge || (Globals::async_checks && AsyncProbes::HasLedgeResult(a_character->GetFormID())))
             {
                 a_translation->x = 0.0f;
                 a_translation->y = 0.0f;
@@ -40,6 +40,38 @@ namespace Hook
         inline static bool running = false;
     };
 
+    // Runs the due ledge checks right after the player's physics world steps, positions are final then.
+    class PhysicsStepListener : public ISingleton<PhysicsStepListener>
+    {
+    public:
+        static void Install();
+
+        inline static bool checksDue{false};
+
+    private:
+        inline static void Thunk(RE::bhkWorld *a_this, std::uint32_t a_updateFlags);
+        inline static REL::Relocation<decltype(&Thunk)> _func;
+        static constexpr std::size_t idx{0x2F}; // bhkWorld::Update
+    };
+
+    // Every character's animation graph events, handed to the attack sink on the main thread for tracked
+    // actors only. Replaces adding the sink to each tracked actor's graph.
+    class AnimationEventHook
+    {
+    public:
+        static void Install();
+
+    private:
+        static RE::BSEventNotifyControl CharacterThunk(RE::BSTEventSink<RE::BSAnimationGraphEvent> *a_sink, RE::BSAnimationGraphEvent *a_event,
+                                                       RE::BSTEventSource<RE::BSAnimationGraphEvent> *a_source);
+        static RE::BSEventNotifyControl PlayerThunk(RE::BSTEventSink<RE::BSAnimationGraphEvent> *a_sink, RE::BSAnimationGraphEvent *a_event,
+                                                    RE::BSTEventSource<RE::BSAnimationGraphEvent> *a_source);
+        static void Forward(RE::BSAnimationGraphEvent *a_event);
+        static inline REL::Relocation<decltype(CharacterThunk)> _characterFunc;
+        static inline REL::Relocation<decltype(PlayerThunk)> _playerFunc;
+        static constexpr std::size_t idx{0x1}; // BSTEventSink<BSAnimationGraphEvent>::ProcessEvent
+    };
+
     class MotionUpdateHook
     {
     public:
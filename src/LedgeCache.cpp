@@ -0,0 +1,255 @@
+namespace LedgeCache
+{
+    const char *cachePath = "Data\\SKSE\\Plugins\\AnimationLedgeBlockNG.ledgecache";
+
+    constexpr std::uint32_t file_magic = 0x43424C41; // "ALBC"
+    constexpr std::uint32_t file_version = 1;
+    constexpr std::uint32_t record_magic = 0x52424C41; // "ALBR"
+
+    struct FileHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+    };
+
+    // Followed by edge_count LedgeMap::Edge. A later record for the same key replaces an earlier one.
+    struct RecordHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t edge_count;
+        std::uint64_t space_hash;
+        std::uint64_t load_order_hash;
+        std::int32_t cell_x;
+        std::int32_t cell_y;
+        std::uint32_t checksum; // CRC32 of the edges
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(FileHeader) == 8);
+    static_assert(sizeof(RecordHeader) == 40);
+
+    struct CellKey
+    {
+        std::uint64_t space_hash = 0;
+        std::int32_t cell_x = 0;
+        std::int32_t cell_y = 0;
+
+        bool operator==(const CellKey &) const = default;
+    };
+
+    struct CellKeyHash
+    {
+        std::size_t operator()(const CellKey &key) const
+        {
+            return static_cast<std::size_t>(key.space_hash ^ (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.cell_x)) << 32 | static_cast<std::uint32_t>(key.cell_y)));
+        }
+    };
+
+    LedgeMap::MappedFile g_file;
+    bool g_opened = false;
+    std::uint64_t g_load_order_hash = 0;
+    // The file only holds edges for the threshold and sample spacing it was opened with, cells measured
+    // after a reload changed them are neither served nor stored
+    float g_drop_threshold = 0.0f;
+    float g_ledge_distance = 0.0f;
+
+    // Records in the mapping, and the ones appended this session which the mapping doesn't cover
+    std::unordered_map<CellKey, std::span<const LedgeMap::Edge>, CellKeyHash> g_mapped;
+    std::unordered_map<CellKey, std::vector<LedgeMap::Edge>, CellKeyHash> g_appended;
+
+    // Hash of the active plugins in load order and the drop threshold and ledge distance the edges were
+    // measured with.
+    std::uint64_t GetLoadOrderHash()
+    {
+        std::string load_order = std::to_string(g_drop_threshold) + "|" + std::to_string(g_ledge_distance);
+        if (auto *data_handler = RE::TESDataHandler::GetSingleton(); data_handler)
+        {
+            for (std::uint8_t i = 0; i < data_handler->GetLoadedModCount(); ++i)
+            {
+                if (const auto *file = data_handler->LookupLoadedModByIndex(i); file)
+                    load_order.append("|").append(file->GetFilename());
+            }
+            for (std::uint16_t i = 0; i < data_handler->GetLoadedLightModCount(); ++i)
+            {
+                if (const auto *file = data_handler->LookupLoadedLightModByIndex(i); file)
+                    load_order.append("|").append(file->GetFilename());
+            }
+        }
+        return LedgeMap::HashEditorID(load_order);
+    }
+
+    // Worldspace and coordinates for exteriors, the cell's editor ID for interiors. False for cells
+    // without an editor ID to key them by.
+    bool GetKey(RE::TESObjectCELL *cell, CellKey &key)
+    {
+        if (cell->IsExteriorCell())
+        {
+            auto *worldspace = cell->GetRuntimeData().worldSpace;
+            auto *coordinates = cell->GetCoordinates();
+            if (!worldspace || !coordinates)
+                return false;
+            const std::string_view editor_id = worldspace->GetFormEditorID();
+            if (editor_id.empty())
+                return false;
+            key = {LedgeMap::HashEditorID(editor_id), coordinates->cellX, coordinates->cellY};
+            return true;
+        }
+        const std::string_view editor_id = cell->GetFormEditorID();
+        if (editor_id.empty())
+            return false;
+        key = {LedgeMap::HashEditorID(editor_id), 0, 0};
+        return true;
+    }
+
+    // Reads records up to the first torn or corrupt one. Returns the bytes of the live records,
+    // those of the current load order that aren't replaced later on.
+    std::size_t ScanRecords(std::span<const std::byte> bytes, std::size_t &valid_end)
+    {
+        std::unordered_map<CellKey, std::size_t, CellKeyHash> record_sizes;
+        std::size_t offset = sizeof(FileHeader);
+        while (offset + sizeof(RecordHeader) <= bytes.size())
+        {
+            RecordHeader record;
+            std::memcpy(&record, bytes.data() + offset, sizeof(record));
+            const std::size_t edges_size = static_cast<std::size_t>(record.edge_count) * sizeof(LedgeMap::Edge);
+            if (record.magic != record_magic || edges_size > bytes.size() - offset - sizeof(RecordHeader))
+                break;
+            const auto edge_bytes = bytes.subspan(offset + sizeof(RecordHeader), edges_size);
+            if (LedgeMap::Crc32(edge_bytes) != record.checksum)
+                break;
+            if (record.load_order_hash == g_load_order_hash)
+            {
+                const CellKey key{record.space_hash, record.cell_x, record.cell_y};
+                g_mapped[key] = {reinterpret_cast<const LedgeMap::Edge *>(edge_bytes.data()), record.edge_count};
+                record_sizes[key] = sizeof(RecordHeader) + edges_size;
+            }
+            offset += sizeof(RecordHeader) + edges_size;
+        }
+        valid_end = offset;
+        std::size_t live_size = 0;
+        for (const auto &[key, size] : record_sizes)
+            live_size += size;
+        return live_size;
+    }
+
+    void WriteRecord(std::ofstream &out, const CellKey &key, std::span<const LedgeMap::Edge> edges)
+    {
+        const auto edge_bytes = std::as_bytes(edges);
+        const RecordHeader record{record_magic, static_cast<std::uint32_t>(edges.size()), key.space_hash, g_load_order_hash,
+                                  key.cell_x, key.cell_y, LedgeMap::Crc32(edge_bytes), 0};
+        out.write(reinterpret_cast<const char *>(&record), sizeof(record));
+        out.write(reinterpret_cast<const char *>(edge_bytes.data()), static_cast<std::streamsize>(edge_bytes.size()));
+    }
+
+    // Rewrites the file with only the live records, dropping other load orders, replaced records
+    // and a torn tail so appends land after valid data.
+    void Compact()
+    {
+        std::unordered_map<CellKey, std::vector<LedgeMap::Edge>, CellKeyHash> live;
+        for (const auto &[key, edges] : g_mapped)
+            live[key].assign(edges.begin(), edges.end());
+        g_mapped.clear();
+        g_file.Close();
+
+        std::ofstream out(cachePath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            logger::error("Couldn't rewrite ledge cache {}"sv, cachePath);
+            return;
+        }
+        const FileHeader header{file_magic, file_version};
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const auto &[key, edges] : live)
+            WriteRecord(out, key, edges);
+        out.close();
+
+        // Reopened so lookups read from the mapping again instead of the copies
+        if (g_file.Open(cachePath))
+        {
+            std::size_t valid_end;
+            ScanRecords(g_file.Bytes(), valid_end);
+        }
+        logger::info("Compacted ledge cache to {} cells"sv, g_mapped.size());
+    }
+
+    void Open()
+    {
+        g_opened = true;
+        g_drop_threshold = Config::Current().drop_threshold;
+        g_ledge_distance = Config::Current().ledge_distance;
+        g_load_order_hash = GetLoadOrderHash();
+        if (!g_file.Open(cachePath))
+        {
+            logger::info("No ledge cache at {}, starting a new one"sv, cachePath);
+            Compact();
+            return;
+        }
+        const auto bytes = g_file.Bytes();
+        FileHeader header{};
+        if (bytes.size() >= sizeof(header))
+            std::memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != file_magic || header.version != file_version)
+        {
+            logger::warn("Discarding ledge cache {} with an unknown format"sv, cachePath);
+            Compact();
+            return;
+        }
+        std::size_t valid_end;
+        const std::size_t live_size = ScanRecords(bytes, valid_end);
+        logger::info("Mapped ledge cache with {} cells for this load order"sv, g_mapped.size());
+        if (valid_end != bytes.size() || live_size < (valid_end - sizeof(FileHeader)) / 2)
+            Compact();
+    }
+
+    bool Lookup(RE::TESObjectCELL *cell, std::vector<LedgeIndex::LedgeEdge> &edges)
+    {
+        if (!cell)
+            return false;
+        if (!g_opened)
+            Open();
+        if (Config::Current().drop_threshold != g_drop_threshold || Config::Current().ledge_distance != g_ledge_distance)
+            return false;
+        CellKey key;
+        if (!GetKey(cell, key))
+            return false;
+        std::span<const LedgeMap::Edge> cached;
+        if (const auto it = g_appended.find(key); it != g_appended.end())
+            cached = it->second;
+        else if (const auto it = g_mapped.find(key); it != g_mapped.end())
+            cached = it->second;
+        else
+            return false;
+
+        edges.clear();
+        edges.reserve(cached.size());
+        for (const auto &edge : cached)
+            edges.push_back({{edge.x0, edge.y0, edge.z0}, {edge.x1, edge.y1, edge.z1}});
+        return true;
+    }
+
+    void Store(RE::TESObjectCELL *cell, const std::vector<LedgeIndex::LedgeEdge> &edges)
+    {
+        if (!cell)
+            return;
+        if (!g_opened)
+            Open();
+        if (Config::Current().drop_threshold != g_drop_threshold || Config::Current().ledge_distance != g_ledge_distance)
+            return;
+        CellKey key;
+        if (!GetKey(cell, key))
+            return;
+        std::vector<LedgeMap::Edge> records;
+        records.reserve(edges.size());
+        for (const auto &edge : edges)
+            records.push_back({edge.start.x, edge.start.y, edge.start.z, edge.end.x, edge.end.y, edge.end.z});
+
+        std::ofstream out(cachePath, std::ios::binary | std::ios::app);
+        if (!out)
+        {
+            logger::error("Couldn't append to ledge cache {}"sv, cachePath);
+            return;
+        }
+        WriteRecord(out, key, records);
+        g_appended[key] = std::move(records);
+    }
+}
\ No newline at end of file
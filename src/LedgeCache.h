@@ -0,0 +1,12 @@
+#pragma once
+
+// Ledge edges indexed at runtime, kept across sessions in an append-only file next to the plugin.
+namespace LedgeCache
+{
+    // Copies the cell's cached edges into edges. The file is mapped on the first lookup.
+    // False if the cell isn't cached for the current load order.
+    bool Lookup(RE::TESObjectCELL *cell, std::vector<LedgeIndex::LedgeEdge> &edges);
+
+    // Appends the cell's edges to the file.
+    void Store(RE::TESObjectCELL *cell, const std::vector<LedgeIndex::LedgeEdge> &edges);
+}
\ No newline at end of file
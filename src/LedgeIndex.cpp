@@ -0,0 +1,255 @@
+namespace LedgeIndex
+{
+    constexpr float bucket_size = 256.0f;
+    constexpr float probe_offset = 24.0f; // How far past the edge the drop is measured
+    constexpr std::uint16_t no_neighbour = 0xFFFF;
+
+    // Edges of one cell, bucketed in a uniform grid over the navmesh's bounds.
+    struct CellIndex
+    {
+        RE::FormID cell_id = 0;
+        bool has_navmesh = false;
+        const void *space = nullptr;
+        float min_x = 0.0f;
+        float min_y = 0.0f;
+        float max_x = 0.0f;
+        float max_y = 0.0f;
+        int width = 0;
+        int height = 0;
+        std::vector<LedgeEdge> edges;
+        std::vector<std::uint32_t> bucket_offsets; // width * height + 1 offsets into bucket_edges
+        std::vector<std::uint32_t> bucket_edges;
+    };
+
+    std::unordered_map<RE::FormID, CellIndex> g_indices;
+
+    const void *GetSpace(RE::TESObjectCELL *cell)
+    {
+        if (cell->IsExteriorCell())
+            return cell->GetRuntimeData().worldSpace;
+        return cell;
+    }
+
+    // Ground height measured straight down from above pos, false if there is no ground within 600 units.
+    bool PickGroundZ(RE::bhkWorld *bhk_world, const RE::NiPoint3 &pos, float &ground_z)
+    {
+        const auto havok_world_scale = RE::bhkWorld::GetWorldScale();
+        const RE::NiPoint3 ray_from = pos + RE::NiPoint3(0, 0, 80);
+        const RE::NiPoint3 ray_to = ray_from + RE::NiPoint3(0, 0, -600.0f);
+        RE::bhkPickData ray;
+        ray.rayInput.from = ray_from * havok_world_scale;
+        ray.rayInput.to = ray_to * havok_world_scale;
+        RE::CFilter cFilter;
+        cFilter.SetCollisionLayer(RE::COL_LAYER::kLineOfSight);
+        ray.rayInput.filterInfo = cFilter;
+        if (!bhk_world->PickObject(ray) || !ray.rayOutput.HasHit())
+            return false;
+        ground_z = ray_from.z + (ray_to.z - ray_from.z) * ray.rayOutput.hitFraction;
+        return true;
+    }
+
+    // Squared distance from p to the edge in the xy plane.
+    float SquaredDistanceToEdge(const LedgeEdge &edge, const RE::NiPoint3 &p)
+    {
+        const float dx = edge.end.x - edge.start.x;
+        const float dy = edge.end.y - edge.start.y;
+        const float length_sq = dx * dx + dy * dy;
+        float t = 0.0f;
+        if (length_sq > 0.0f)
+            t = std::clamp(((p.x - edge.start.x) * dx + (p.y - edge.start.y) * dy) / length_sq, 0.0f, 1.0f);
+        const float ex = edge.start.x + dx * t - p.x;
+        const float ey = edge.start.y + dy * t - p.y;
+        return ex * ex + ey * ey;
+    }
+
+    void BuildIndex(RE::TESObjectCELL *cell)
+    {
+        if (!cell)
+            return;
+        CellIndex index;
+        index.cell_id = cell->GetFormID();
+        index.space = GetSpace(cell);
+        auto *navmeshes = cell->GetRuntimeData().navMeshes;
+        auto *bhk_world = cell->GetbhkWorld();
+        if (!navmeshes || navmeshes->navMeshes.empty() || !bhk_world)
+        {
+            // Remembered so the cell isn't walked again every check, rays are used there instead
+            g_indices[index.cell_id] = std::move(index);
+            return;
+        }
+        index.has_navmesh = true;
+        std::size_t boundary_edges = 0;
+        const bool cached = Globals::persistent_ledge_cache && LedgeCache::Lookup(cell, index.edges);
+        // A cached cell skips the walk and its rays
+        if (!cached)
+        {
+            const float drop_threshold = Config::Current().drop_threshold;
+            const float ledge_distance = Config::Current().ledge_distance;
+            for (const auto &navmesh : navmeshes->navMeshes)
+            {
+                if (!navmesh)
+                    continue;
+                const auto &vertices = navmesh->vertices;
+                for (const auto &triangle : navmesh->triangles)
+                {
+                    for (int e = 0; e < 3; ++e)
+                    {
+                        if (triangle.triangles[e] != no_neighbour)
+                            continue;
+                        const auto &a = vertices[triangle.vertices[e]].location;
+                        const auto &b = vertices[triangle.vertices[(e + 1) % 3]].location;
+                        const auto &c = vertices[triangle.vertices[(e + 2) % 3]].location;
+                        ++boundary_edges;
+
+                        // Outward normal, away from the triangle's third vertex
+                        RE::NiPoint3 normal(b.y - a.y, a.x - b.x, 0.0f);
+                        if (normal.Unitize() == 0.0f)
+                            continue;
+                        if (normal.Dot(c - a) > 0.0f)
+                            normal = -normal;
+
+                        // The drop is sampled every ledge_distance along the edge, so a drop the probes could
+                        // reach anywhere on it is seen. Each run of dropping samples is indexed on its own.
+                        const int samples = std::max(1, static_cast<int>(std::ceil(a.GetDistance(b) / ledge_distance)));
+                        const auto point_at = [&](int s) { return s == samples ? b : a + (b - a) * (static_cast<float>(s) / samples); };
+                        int run_start = -1;
+                        for (int s = 0; s <= samples; ++s)
+                        {
+                            bool drops = false;
+                            if (s < samples)
+                            {
+                                const RE::NiPoint3 sample = a + (b - a) * ((s + 0.5f) / samples);
+                                float ground_z;
+                                drops = !PickGroundZ(bhk_world, sample + normal * probe_offset, ground_z) || sample.z - ground_z > drop_threshold;
+                            }
+                            if (drops && run_start < 0)
+                                run_start = s;
+                            else if (!drops && run_start >= 0)
+                            {
+                                index.edges.push_back({point_at(run_start), point_at(s)});
+                                run_start = -1;
+                            }
+                        }
+                    }
+                }
+            }
+            if (Globals::persistent_ledge_cache)
+                LedgeCache::Store(cell, index.edges);
+        }
+
+        index.min_x = index.min_y = std::numeric_limits<float>::max();
+        index.max_x = index.max_y = std::numeric_limits<float>::lowest();
+        for (const auto &edge : index.edges)
+        {
+            index.min_x = std::min({index.min_x, edge.start.x, edge.end.x});
+            index.min_y = std::min({index.min_y, edge.start.y, edge.end.y});
+            index.max_x = std::max({index.max_x, edge.start.x, edge.end.x});
+            index.max_y = std::max({index.max_y, edge.start.y, edge.end.y});
+        }
+
+        // Bucket the edges by the squares their bounding boxes touch
+        if (!index.edges.empty())
+        {
+            index.width = static_cast<int>((index.max_x - index.min_x) / bucket_size) + 1;
+            index.height = static_cast<int>((index.max_y - index.min_y) / bucket_size) + 1;
+        }
+        const auto bucket_range = [&](const LedgeEdge &edge, int &x0, int &y0, int &x1, int &y1) {
+            x0 = static_cast<int>((std::min(edge.start.x, edge.end.x) - index.min_x) / bucket_size);
+            x1 = static_cast<int>((std::max(edge.start.x, edge.end.x) - index.min_x) / bucket_size);
+            y0 = static_cast<int>((std::min(edge.start.y, edge.end.y) - index.min_y) / bucket_size);
+            y1 = static_cast<int>((std::max(edge.start.y, edge.end.y) - index.min_y) / bucket_size);
+        };
+        std::vector<std::uint32_t> counts(static_cast<std::size_t>(index.width) * index.height + 1, 0);
+        for (const auto &edge : index.edges)
+        {
+            int x0, y0, x1, y1;
+            bucket_range(edge, x0, y0, x1, y1);
+            for (int y = y0; y <= y1; ++y)
+                for (int x = x0; x <= x1; ++x)
+                    ++counts[y * index.width + x + 1];
+        }
+        for (std::size_t i = 1; i < counts.size(); ++i)
+            counts[i] += counts[i - 1];
+        index.bucket_offsets = counts;
+        index.bucket_edges.resize(counts.back());
+        for (std::uint32_t edge_index = 0; edge_index < index.edges.size(); ++edge_index)
+        {
+            int x0, y0, x1, y1;
+            bucket_range(index.edges[edge_index], x0, y0, x1, y1);
+            for (int y = y0; y <= y1; ++y)
+                for (int x = x0; x <= x1; ++x)
+                    index.bucket_edges[counts[y * index.width + x]++] = edge_index;
+        }
+
+        if (cached)
+            logger::debug("Loaded {} cached ledge edges for cell {:X}"sv, index.edges.size(), index.cell_id);
+        else
+            logger::debug("Indexed {} ledge edges of {} navmesh boundary edges in cell {:X}"sv, index.edges.size(), boundary_edges, index.cell_id);
+        g_indices[index.cell_id] = std::move(index);
+    }
+
+    void EnsureIndex(RE::TESObjectCELL *cell)
+    {
+        if (cell && !g_indices.contains(cell->GetFormID()))
+            BuildIndex(cell);
+    }
+
+    void EvictDetachedCells()
+    {
+        for (auto it = g_indices.begin(); it != g_indices.end();)
+        {
+            const auto cell = RE::TESForm::LookupByID<RE::TESObjectCELL>(it->first);
+            if (!cell || !cell->IsAttached())
+                it = g_indices.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    bool HasIndex(RE::TESObjectCELL *cell)
+    {
+        if (!cell)
+            return false;
+        const auto it = g_indices.find(cell->GetFormID());
+        return it != g_indices.end() && it->second.has_navmesh;
+    }
+
+    const std::vector<LedgeEdge> *GetEdges(RE::TESObjectCELL *cell)
+    {
+        if (!cell)
+            return nullptr;
+        const auto it = g_indices.find(cell->GetFormID());
+        if (it == g_indices.end() || !it->second.has_navmesh)
+            return nullptr;
+        return &it->second.edges;
+    }
+
+    float DistanceToNearestLedge(RE::TESObjectCELL *cell, const RE::NiPoint3 &pos, float max_distance, bool (*skip_cell)(RE::FormID))
+    {
+        if (!cell)
+            return max_distance;
+        const void *space = GetSpace(cell);
+        float best_sq = max_distance * max_distance;
+        for (const auto &[cell_id, index] : g_indices)
+        {
+            if (index.space != space || index.edges.empty() || (skip_cell && skip_cell(cell_id)) ||
+                pos.x + max_distance < index.min_x || pos.x - max_distance > index.max_x ||
+                pos.y + max_distance < index.min_y || pos.y - max_distance > index.max_y)
+                continue;
+            const int x0 = std::max(static_cast<int>((pos.x - max_distance - index.min_x) / bucket_size), 0);
+            const int x1 = std::min(static_cast<int>((pos.x + max_distance - index.min_x) / bucket_size), index.width - 1);
+            const int y0 = std::max(static_cast<int>((pos.y - max_distance - index.min_y) / bucket_size), 0);
+            const int y1 = std::min(static_cast<int>((pos.y + max_distance - index.min_y) / bucket_size), index.height - 1);
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    const int bucket = y * index.width + x;
+                    for (std::uint32_t i = index.bucket_offsets[bucket]; i < index.bucket_offsets[bucket + 1]; ++i)
+                        best_sq = std::min(best_sq, SquaredDistanceToEdge(index.edges[index.bucket_edges[i]], pos));
+                }
+            }
+        }
+        return std::sqrt(best_sq);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace LedgeIndex
+{
+    // Navmesh boundary edge with a drop behind it.
+    struct LedgeEdge
+    {
+        RE::NiPoint3 start;
+        RE::NiPoint3 end;
+    };
+
+    // Worldspace for exterior cells, the cell itself for interiors.
+    const void *GetSpace(RE::TESObjectCELL *cell);
+
+    // Walks the cell's navmeshes and indexes the boundary edges that have a drop past them.
+    void BuildIndex(RE::TESObjectCELL *cell);
+
+    // Builds the cell's index if it doesn't have one yet.
+    void EnsureIndex(RE::TESObjectCELL *cell);
+
+    void EvictDetachedCells();
+
+    // True if the cell's navmesh has been indexed.
+    bool HasIndex(RE::TESObjectCELL *cell);
+
+    // The cell's indexed edges, nullptr if its navmesh hasn't been indexed.
+    const std::vector<LedgeEdge> *GetEdges(RE::TESObjectCELL *cell);
+
+    // Distance from pos to the nearest indexed ledge edge in the same interior or worldspace,
+    // max_distance if there is none closer. Cells skip_cell returns true for are left out.
+    float DistanceToNearestLedge(RE::TESObjectCELL *cell, const RE::NiPoint3 &pos, float max_distance, bool (*skip_cell)(RE::FormID) = nullptr);
+}
\ No newline at end of file
@@ -0,0 +1,408 @@
+#include "LedgeMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+#ifdef _WIN32
+#    include <Windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace LedgeMap
+{
+    constexpr float infinite = 1e20f;
+
+    constexpr std::array<std::uint32_t, 256> crc_table = [] {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    std::uint64_t HashEditorID(std::string_view editor_id)
+    {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        for (const char c : editor_id)
+        {
+            hash ^= static_cast<std::uint8_t>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    std::uint32_t Crc32(std::span<const std::byte> bytes, std::uint32_t crc)
+    {
+        crc ^= 0xFFFFFFFFu;
+        for (const std::byte b : bytes)
+            crc = crc_table[(crc ^ static_cast<std::uint8_t>(b)) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    std::uint32_t FileChecksum(const Header &header, std::span<const std::byte> tables)
+    {
+        Header unsigned_header = header;
+        unsigned_header.checksum = 0;
+        const auto crc = Crc32(std::as_bytes(std::span(&unsigned_header, 1)));
+        return Crc32(tables, crc);
+    }
+
+    // 1D squared Euclidean distance transform of f (Felzenszwalb & Huttenlocher), written to d.
+    void Transform1D(const std::vector<float> &f, int n, std::vector<float> &d, std::vector<int> &v, std::vector<float> &z)
+    {
+        int k = 0;
+        v[0] = 0;
+        z[0] = -infinite;
+        z[1] = infinite;
+        for (int q = 1; q < n; ++q)
+        {
+            float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+            while (s <= z[k])
+            {
+                --k;
+                s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = infinite;
+        }
+        k = 0;
+        for (int q = 0; q < n; ++q)
+        {
+            while (z[k + 1] < q)
+                ++k;
+            const float delta = static_cast<float>(q - v[k]);
+            d[q] = delta * delta + f[v[k]];
+        }
+    }
+
+    Field BuildDistanceField(std::span<const Edge> edges, float margin, float spacing, int max_samples)
+    {
+        Field field;
+        field.spacing = spacing;
+        field.margin = margin;
+        if (edges.empty())
+            return field;
+
+        float min_x = std::numeric_limits<float>::max();
+        float min_y = std::numeric_limits<float>::max();
+        float max_x = std::numeric_limits<float>::lowest();
+        float max_y = std::numeric_limits<float>::lowest();
+        for (const auto &edge : edges)
+        {
+            min_x = std::min({min_x, edge.x0, edge.x1});
+            min_y = std::min({min_y, edge.y0, edge.y1});
+            max_x = std::max({max_x, edge.x0, edge.x1});
+            max_y = std::max({max_y, edge.y0, edge.y1});
+        }
+        field.origin_x = min_x - margin;
+        field.origin_y = min_y - margin;
+        const float extent = std::max(max_x - min_x, max_y - min_y) + 2.0f * margin;
+        while (extent / field.spacing + 2.0f > max_samples)
+            field.spacing *= 2.0f;
+        field.width = static_cast<int>((max_x - min_x + 2.0f * margin) / field.spacing) + 2;
+        field.height = static_cast<int>((max_y - min_y + 2.0f * margin) / field.spacing) + 2;
+
+        // Seed every sample an edge passes through
+        std::vector<float> grid(static_cast<std::size_t>(field.width) * field.height, infinite);
+        for (const auto &edge : edges)
+        {
+            const float length = std::hypot(edge.x1 - edge.x0, edge.y1 - edge.y0);
+            const int steps = static_cast<int>(length / (field.spacing * 0.5f)) + 1;
+            for (int step = 0; step <= steps; ++step)
+            {
+                const float t = static_cast<float>(step) / steps;
+                const int x = static_cast<int>(std::lround((edge.x0 + (edge.x1 - edge.x0) * t - field.origin_x) / field.spacing));
+                const int y = static_cast<int>(std::lround((edge.y0 + (edge.y1 - edge.y0) * t - field.origin_y) / field.spacing));
+                grid[static_cast<std::size_t>(y) * field.width + x] = 0.0f;
+            }
+        }
+
+        // Columns, then rows
+        const int longest = std::max(field.width, field.height);
+        std::vector<float> f(longest);
+        std::vector<float> d(longest);
+        std::vector<int> v(longest);
+        std::vector<float> z(longest + 1);
+        for (int x = 0; x < field.width; ++x)
+        {
+            for (int y = 0; y < field.height; ++y)
+                f[y] = grid[static_cast<std::size_t>(y) * field.width + x];
+            Transform1D(f, field.height, d, v, z);
+            for (int y = 0; y < field.height; ++y)
+                grid[static_cast<std::size_t>(y) * field.width + x] = d[y];
+        }
+        field.distances.resize(grid.size());
+        for (int y = 0; y < field.height; ++y)
+        {
+            std::copy_n(grid.begin() + static_cast<std::ptrdiff_t>(y) * field.width, field.width, f.begin());
+            Transform1D(f, field.width, d, v, z);
+            for (int x = 0; x < field.width; ++x)
+            {
+                const float distance = std::sqrt(d[x]) * field.spacing;
+                field.distances[static_cast<std::size_t>(y) * field.width + x] = static_cast<std::uint16_t>(std::min(distance, 65535.0f));
+            }
+        }
+        return field;
+    }
+
+    float SampleDistance(const FieldView &field, float x, float y, float max_distance)
+    {
+        if (!field.distances || field.width < 2 || field.height < 2)
+            return max_distance; // No edges at all
+        const float grid_x = (x - field.origin_x) / field.spacing;
+        const float grid_y = (y - field.origin_y) / field.spacing;
+        if (grid_x < 0.0f || grid_y < 0.0f || grid_x >= field.width - 1 || grid_y >= field.height - 1)
+            return std::min(field.margin, max_distance);
+        const int sample_x = static_cast<int>(grid_x);
+        const int sample_y = static_cast<int>(grid_y);
+        const float tx = grid_x - sample_x;
+        const float ty = grid_y - sample_y;
+        const std::size_t row = static_cast<std::size_t>(sample_y) * field.width;
+        const float d00 = field.distances[row + sample_x];
+        const float d10 = field.distances[row + sample_x + 1];
+        const float d01 = field.distances[row + field.width + sample_x];
+        const float d11 = field.distances[row + field.width + sample_x + 1];
+        const float distance = (d00 * (1.0f - tx) + d10 * tx) * (1.0f - ty) + (d01 * (1.0f - tx) + d11 * tx) * ty;
+        return std::min(distance, max_distance);
+    }
+
+    template <class T>
+    void Append(std::vector<std::byte> &out, const T *items, std::size_t count)
+    {
+        const auto *bytes = reinterpret_cast<const std::byte *>(items);
+        out.insert(out.end(), bytes, bytes + sizeof(T) * count);
+        while (out.size() % 4 != 0)
+            out.push_back(std::byte{0});
+    }
+
+    std::vector<std::byte> Serialize(std::vector<BakedCell> cells)
+    {
+        std::ranges::sort(cells, [](const BakedCell &a, const BakedCell &b) {
+            return std::tie(a.space_hash, a.cell_x, a.cell_y) < std::tie(b.space_hash, b.cell_x, b.cell_y);
+        });
+
+        std::vector<CellRecord> records;
+        std::vector<Edge> all_edges;
+        std::vector<std::uint16_t> all_distances;
+        for (const auto &cell : cells)
+        {
+            CellRecord record{};
+            record.space_hash = cell.space_hash;
+            record.cell_x = cell.cell_x;
+            record.cell_y = cell.cell_y;
+            record.edge_offset = static_cast<std::uint32_t>(all_edges.size());
+            record.edge_count = static_cast<std::uint32_t>(cell.edges.size());
+            record.distance_offset = static_cast<std::uint32_t>(all_distances.size());
+            record.field_width = static_cast<std::uint32_t>(cell.field.width);
+            record.field_height = static_cast<std::uint32_t>(cell.field.height);
+            record.field_origin_x = cell.field.origin_x;
+            record.field_origin_y = cell.field.origin_y;
+            record.field_spacing = cell.field.spacing;
+            record.field_margin = cell.field.margin;
+            records.push_back(record);
+            all_edges.insert(all_edges.end(), cell.edges.begin(), cell.edges.end());
+            all_distances.insert(all_distances.end(), cell.field.distances.begin(), cell.field.distances.end());
+        }
+
+        Header header{};
+        header.magic = file_magic;
+        header.version = file_version;
+        header.cell_count = static_cast<std::uint32_t>(records.size());
+
+        std::vector<std::byte> out;
+        Append(out, &header, 1);
+        Append(out, records.data(), records.size());
+        header.edges_offset = out.size();
+        Append(out, all_edges.data(), all_edges.size());
+        header.distances_offset = out.size();
+        Append(out, all_distances.data(), all_distances.size());
+        header.file_size = out.size();
+        header.checksum = FileChecksum(header, std::span(out).subspan(sizeof(Header)));
+        std::memcpy(out.data(), &header, sizeof(Header));
+        return out;
+    }
+
+    bool View::Open(std::span<const std::byte> bytes, std::string &error)
+    {
+        *this = View{};
+        Header header;
+        if (bytes.size() < sizeof(Header))
+        {
+            error = "file is smaller than the header";
+            return false;
+        }
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+        if (header.magic != file_magic)
+        {
+            error = "not a ledge map";
+            return false;
+        }
+        if (header.version != file_version)
+        {
+            error = "unsupported version " + std::to_string(header.version);
+            return false;
+        }
+        if (header.file_size != bytes.size())
+        {
+            error = "size mismatch, file is truncated or padded";
+            return false;
+        }
+        const std::uint64_t records_end = sizeof(Header) + static_cast<std::uint64_t>(header.cell_count) * sizeof(CellRecord);
+        if (records_end > header.edges_offset || header.edges_offset > header.distances_offset ||
+            header.distances_offset > header.file_size || header.edges_offset % 4 != 0 || header.distances_offset % 4 != 0)
+        {
+            error = "table offsets out of bounds";
+            return false;
+        }
+        if (FileChecksum(header, bytes.subspan(sizeof(Header))) != header.checksum)
+        {
+            error = "checksum mismatch";
+            return false;
+        }
+
+        const auto *base = bytes.data();
+        std::span<const CellRecord> records(reinterpret_cast<const CellRecord *>(base + sizeof(Header)), header.cell_count);
+        std::span<const Edge> edge_table(reinterpret_cast<const Edge *>(base + header.edges_offset),
+                                         (header.distances_offset - header.edges_offset) / sizeof(Edge));
+        std::span<const std::uint16_t> distance_table(reinterpret_cast<const std::uint16_t *>(base + header.distances_offset),
+                                                      (header.file_size - header.distances_offset) / sizeof(std::uint16_t));
+        for (const auto &record : records)
+        {
+            const std::uint64_t field_size = static_cast<std::uint64_t>(record.field_width) * record.field_height;
+            if (static_cast<std::uint64_t>(record.edge_offset) + record.edge_count > edge_table.size() ||
+                record.distance_offset + field_size > distance_table.size())
+            {
+                error = "cell record out of bounds";
+                return false;
+            }
+        }
+        cells = records;
+        edges = edge_table;
+        distances = distance_table;
+        return true;
+    }
+
+    const CellRecord *View::FindCell(std::uint64_t space_hash, std::int32_t cell_x, std::int32_t cell_y) const
+    {
+        const auto key = std::tie(space_hash, cell_x, cell_y);
+        const auto it = std::ranges::lower_bound(cells, key, std::less{}, [](const CellRecord &record) {
+            return std::tie(record.space_hash, record.cell_x, record.cell_y);
+        });
+        if (it == cells.end() || std::tie(it->space_hash, it->cell_x, it->cell_y) != key)
+            return nullptr;
+        return &*it;
+    }
+
+    std::span<const Edge> View::GetEdges(const CellRecord &cell) const
+    {
+        return edges.subspan(cell.edge_offset, cell.edge_count);
+    }
+
+    FieldView View::GetField(const CellRecord &cell) const
+    {
+        FieldView field;
+        field.origin_x = cell.field_origin_x;
+        field.origin_y = cell.field_origin_y;
+        field.spacing = cell.field_spacing;
+        field.margin = cell.field_margin;
+        field.width = static_cast<int>(cell.field_width);
+        field.height = static_cast<int>(cell.field_height);
+        if (cell.field_width && cell.field_height)
+            field.distances = distances.data() + cell.distance_offset;
+        return field;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+#ifdef _WIN32
+    bool MappedFile::Open(const std::string &path)
+    {
+        Close();
+        file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            file_handle = nullptr;
+            return false;
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+        {
+            Close();
+            return false;
+        }
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_handle)
+        {
+            Close();
+            return false;
+        }
+        data = static_cast<const std::byte *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        if (!data)
+        {
+            Close();
+            return false;
+        }
+        size = static_cast<std::size_t>(file_size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping_handle)
+            CloseHandle(mapping_handle);
+        if (file_handle)
+            CloseHandle(file_handle);
+        data = nullptr;
+        size = 0;
+        mapping_handle = nullptr;
+        file_handle = nullptr;
+    }
+#else
+    bool MappedFile::Open(const std::string &path)
+    {
+        Close();
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+        void *mapped = mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+            return false;
+        data = static_cast<const std::byte *>(mapped);
+        size = static_cast<std::size_t>(file_stat.st_size);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (data)
+            munmap(const_cast<std::byte *>(data), size);
+        data = nullptr;
+        size = 0;
+    }
+#endif
+}
\ No newline at end of file
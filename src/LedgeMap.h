@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Baked ledge map: per-cell ledge edges and distance fields, written by the ledgebake tool and
+// memory-mapped by the plugin. Little-endian, every table 4-byte aligned, read in place.
+// No game headers here, this file is also built into the tools.
+namespace LedgeMap
+{
+    constexpr std::uint32_t file_magic = 0x4D424C41; // "ALBM"
+    constexpr std::uint32_t file_version = 2;
+    constexpr float cell_size = 4096.0f; // Exterior cell size in units
+
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t cell_count;
+        std::uint32_t checksum; // CRC32 of the whole file, with this field zeroed
+        std::uint64_t file_size;
+        std::uint64_t edges_offset;     // Byte offset of the Edge table
+        std::uint64_t distances_offset; // Byte offset of the uint16 distance table
+    };
+
+    // Cells are sorted by (space_hash, cell_x, cell_y). Interiors use cell 0, 0.
+    struct CellRecord
+    {
+        std::uint64_t space_hash; // HashEditorID of the worldspace, or of the interior cell
+        std::int32_t cell_x;
+        std::int32_t cell_y;
+        std::uint32_t edge_offset; // Index into the Edge table
+        std::uint32_t edge_count;
+        std::uint32_t distance_offset; // Index into the distance table
+        std::uint32_t field_width;
+        std::uint32_t field_height;
+        float field_origin_x;
+        float field_origin_y;
+        float field_spacing;
+        float field_margin; // Points further than this from every edge are outside the field
+        std::uint32_t reserved;
+    };
+
+    struct Edge
+    {
+        float x0, y0, z0;
+        float x1, y1, z1;
+    };
+
+    static_assert(sizeof(Header) == 40);
+    static_assert(sizeof(CellRecord) == 56);
+    static_assert(sizeof(Edge) == 24);
+
+    // Distance to the nearest edge sampled on a grid, in whole units saturated at 65535.
+    struct FieldView
+    {
+        float origin_x = 0.0f;
+        float origin_y = 0.0f;
+        float spacing = 0.0f;
+        float margin = 0.0f;
+        int width = 0;
+        int height = 0;
+        const std::uint16_t *distances = nullptr;
+    };
+
+    struct Field
+    {
+        float origin_x = 0.0f;
+        float origin_y = 0.0f;
+        float spacing = 0.0f;
+        float margin = 0.0f;
+        int width = 0;
+        int height = 0;
+        std::vector<std::uint16_t> distances;
+
+        FieldView View() const { return {origin_x, origin_y, spacing, margin, width, height, distances.data()}; }
+    };
+
+    // FNV-1a of the lowercased editor ID.
+    std::uint64_t HashEditorID(std::string_view editor_id);
+
+    // Pass the previous result as crc to continue a checksum over several spans.
+    std::uint32_t Crc32(std::span<const std::byte> bytes, std::uint32_t crc = 0);
+
+    // Checksum of a serialized map: the header with its checksum zeroed, then the tables.
+    std::uint32_t FileChecksum(const Header &header, std::span<const std::byte> tables);
+
+    // Exact Euclidean distance transform of the edges, rasterized at spacing (doubled until
+    // both axes fit in max_samples), covering the edges plus margin.
+    Field BuildDistanceField(std::span<const Edge> edges, float margin, float spacing, int max_samples);
+
+    // Bilinear distance to the nearest edge at x, y, clamped to max_distance. Outside the field
+    // the distance is only known to be at least the margin.
+    float SampleDistance(const FieldView &field, float x, float y, float max_distance);
+
+    struct BakedCell
+    {
+        std::uint64_t space_hash = 0;
+        std::int32_t cell_x = 0;
+        std::int32_t cell_y = 0;
+        std::vector<Edge> edges;
+        Field field;
+    };
+
+    std::vector<std::byte> Serialize(std::vector<BakedCell> cells);
+
+    // Read-only view over a serialized ledge map, nothing is copied.
+    class View
+    {
+    public:
+        // Checks magic, version, table bounds and checksum. On failure the view stays empty.
+        bool Open(std::span<const std::byte> bytes, std::string &error);
+
+        const CellRecord *FindCell(std::uint64_t space_hash, std::int32_t cell_x, std::int32_t cell_y) const;
+
+        std::span<const Edge> GetEdges(const CellRecord &cell) const;
+
+        FieldView GetField(const CellRecord &cell) const;
+
+        std::span<const CellRecord> Cells() const { return cells; }
+
+    private:
+        std::span<const CellRecord> cells;
+        std::span<const Edge> edges;
+        std::span<const std::uint16_t> distances;
+    };
+
+    // Read-only memory mapping of a whole file, others may still append to it.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        ~MappedFile();
+
+        bool Open(const std::string &path);
+
+        void Close();
+
+        std::span<const std::byte> Bytes() const { return {data, size}; }
+
+    private:
+        const std::byte *data = nullptr;
+        std::size_t size = 0;
+#ifdef _WIN32
+        void *file_handle = nullptr;
+        void *mapping_handle = nullptr;
+#endif
+    };
+}
\ No newline at end of file
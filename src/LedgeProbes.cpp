@@ -1,4 +1,6 @@
-namespace MathUtils
+#include "LedgeProbes.h"
+
+namespace LedgeProbes
 {
     float AverageAngles(const std::vector<float> &angles)
     {
@@ -20,10 +22,10 @@ namespace MathUtils
 
     float NormalizeAngle(const float angle)
     {
-        return std::fmod((angle + 2 * RE::NI_PI), (2 * RE::NI_PI));
+        return std::fmod((angle + 2 * static_cast<float>(pi)), (2 * static_cast<float>(pi)));
     }
 
-    bool IsMaxMinZPastDropThreshold(const std::vector<float> hitZ, const std::vector<float> opHitZ, float actor_z)
+    bool IsMaxMinZPastDropThreshold(const std::vector<float> &hitZ, const std::vector<float> &opHitZ, float actor_z, const Params &params)
     {
         if (hitZ.empty() || opHitZ.empty())
             return false;
@@ -33,7 +35,7 @@ namespace MathUtils
             max = std::max(z, max);
         }
         max = std::min(max, actor_z);
-        if (max <= actor_z - Globals::ground_leeway)
+        if (max <= actor_z - params.ground_leeway)
             return false;
         float min = hitZ[0];
         for (const float z : hitZ)
@@ -42,7 +44,7 @@ namespace MathUtils
         }
         auto diff = max - min;
         // logger::trace("Diff {}"sv, diff);
-        if (diff >= Globals::drop_threshold)
+        if (diff >= params.drop_threshold)
             return true;
         else
             return false;
@@ -0,0 +1,421 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// The ledge probe algorithms on their own. Every ray goes through a context, the plugin's casts
+// them into the physics world and the tools answer them from a replay log, so both run exactly
+// the same decisions. No game headers here, this file is also built into the tools.
+//
+// A context C provides:
+//   static constexpr bool two_phase_rays;                  Cast short rays first, extend them only when needed
+//   bool Cast(const Vec3 &from, float length, Vec3 &hit);  Vertical ray down from from, false on a miss
+//   bool Pick(const Vec3 &from, const Vec3 &to, Vec3 &hit); Any segment, false on a miss
+//   void Marker(int &index, const Vec3 &hit);              Debug marker for a hit, advances index
+namespace LedgeProbes
+{
+    constexpr double pi = 3.14159265358979323846;
+    constexpr int num_rays = 12; // Number of rays to create.
+    constexpr float ray_length = 600.0f;
+    constexpr int reduced_forward_rays = 3; // Forward rays of the reduced ring
+
+    struct Vec3
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+
+        constexpr Vec3() = default;
+        constexpr Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+        constexpr Vec3 operator+(const Vec3 &other) const { return {x + other.x, y + other.y, z + other.z}; }
+        constexpr Vec3 operator-(const Vec3 &other) const { return {x - other.x, y - other.y, z - other.z}; }
+        constexpr Vec3 operator*(float scale) const { return {x * scale, y * scale, z * scale}; }
+        constexpr float Dot(const Vec3 &other) const { return x * other.x + y * other.y + z * other.z; }
+    };
+
+    // Tuning of the probes, see the ini's [Tweaks] and [Performance].
+    struct Params
+    {
+        float drop_threshold = 150.0f;
+        float ledge_distance = 25.0f;
+        float ground_leeway = 90.0f;
+        int refine_steps = 3;
+        // First phases of two-phase probes, from Derive
+        float forward_short_length = ray_length;
+        float opposite_short_length = ray_length;
+
+        // Computes the values that follow from the tuning.
+        void Derive()
+        {
+            // A forward probe that misses its short phase ends more than drop_threshold + ground_leeway below
+            // the actor, an opposite probe more than ground_leeway below, so the rest of the ray can only
+            // matter against a low opposite reference.
+            forward_short_length = 80.0f + drop_threshold + ground_leeway;
+            // A full miss counts as drop_threshold + 10 below, which only outranks the short end for a huge leeway
+            opposite_short_length = ground_leeway > drop_threshold + 10.0f ? std::numeric_limits<float>::max() : 80.0f + ground_leeway;
+        }
+    };
+
+    // What a check knows about the actor.
+    struct Input
+    {
+        Vec3 actor_pos;
+        Vec3 move_direction; // Unit, horizontal
+        float actor_yaw = 0.0f;
+    };
+
+    // What a check found. best_yaw is carried from one check of the actor to the next.
+    struct Output
+    {
+        float best_yaw = 0.0f;
+        float ledge_lip_distance = 0.0f; // How far ahead the drop starts, 0 if this check didn't locate it
+    };
+
+    // Unit direction (sin, cos) of a ray of the probe ring, relative to the actor's yaw.
+    struct RingDirection
+    {
+        float x;
+        float y;
+    };
+
+    // Taylor series sine, only used to build the ray direction table at compile time.
+    constexpr double ConstexprSin(double angle)
+    {
+        while (angle > pi)
+            angle -= 2.0 * pi;
+        while (angle < -pi)
+            angle += 2.0 * pi;
+        double term = angle;
+        double sum = angle;
+        for (int n = 1; n < 12; ++n)
+        {
+            term *= -angle * angle / ((2.0 * n) * (2.0 * n + 1.0));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr float ray_angle_step = static_cast<float>(2.0 * pi / num_rays);
+
+    constexpr std::array<RingDirection, num_rays> ray_directions = [] {
+        std::array<RingDirection, num_rays> directions{};
+        for (int i = 0; i < num_rays; ++i)
+        {
+            const double angle = i * 2.0 * pi / num_rays;
+            directions[i] = {static_cast<float>(ConstexprSin(angle)), static_cast<float>(ConstexprSin(angle + pi / 2.0))};
+        }
+        return directions;
+    }();
+
+    float AverageAngles(const std::vector<float> &angles);
+
+    float NormalizeAngle(const float angle);
+
+    bool IsMaxMinZPastDropThreshold(const std::vector<float> &hitZ, const std::vector<float> &opHitZ, float actor_z, const Params &params);
+
+    template <class C>
+    float ShortProbeLength(const Params &params, bool opposite_dir)
+    {
+        if constexpr (!C::two_phase_rays)
+            return ray_length;
+        return std::min(opposite_dir ? params.opposite_short_length : params.forward_short_length, ray_length);
+    }
+
+    // Forward probe whose short phase missed, resolved once the opposite reference is known.
+    struct DeferredProbe
+    {
+        Vec3 short_end;
+        float yaw;
+    };
+
+    // Adds the deferred forward probes to hit_z. The long phase is only cast when the opposite reference
+    // lies between ground_leeway and 10 units below the actor and the resolved probes don't already find
+    // a drop, the only case where a full miss and a deep hit lead to different decisions.
+    template <class C>
+    void ResolveDeferredProbes(C &context, const Params &params, int &marker_index, float actor_z, const std::vector<DeferredProbe> &deferred,
+                               std::vector<float> &hit_z, const std::vector<float> &op_hit_z, std::vector<float> *valid_yaws)
+    {
+        if (deferred.empty())
+            return;
+        const float reference_z = std::min(*std::ranges::max_element(op_hit_z), actor_z);
+        bool needs_long = reference_z > actor_z - params.ground_leeway && reference_z < actor_z - 10.0f;
+        if (needs_long && !hit_z.empty() && reference_z - *std::ranges::min_element(hit_z) >= params.drop_threshold)
+            needs_long = false;
+
+        const float remaining_length = ray_length - ShortProbeLength<C>(params, false);
+        for (const auto &probe : deferred)
+        {
+            if (!needs_long)
+            {
+                hit_z.push_back(probe.short_end.z);
+                if (valid_yaws)
+                    valid_yaws->push_back(probe.yaw);
+                continue;
+            }
+            Vec3 hit_pos;
+            if (context.Cast(probe.short_end, remaining_length, hit_pos))
+            {
+                context.Marker(marker_index, hit_pos);
+                hit_z.push_back(hit_pos.z);
+                if (valid_yaws)
+                    valid_yaws->push_back(probe.yaw);
+            }
+            else
+                hit_z.push_back(actor_z - params.drop_threshold - 10);
+        }
+    }
+
+    // A forward ray of the ring, yaw unwrapped so neighbours stay one ray_angle_step apart.
+    struct RingRay
+    {
+        float yaw;
+        bool drop;
+    };
+
+    // Casts the ring's rays: num_rays around the actor, only those aligned with the movement, at
+    // ledge_distance ahead and 100 units behind. Fills the heights the decision compares and the yaws
+    // of the forward rays that found a drop, and forward_rays in yaw order when given. A reduced ring
+    // keeps only the rays closest to the movement, reduced_forward_rays ahead and one behind.
+    template <class C>
+    void CastRing(C &context, const Params &params, const Input &input, int &marker_index, std::vector<float> &hit_z, std::vector<float> &op_hit_z,
+                  std::vector<float> &valid_yaws, std::vector<RingRay> *forward_rays, bool reduced = false)
+    {
+        const Vec3 &actor_pos = input.actor_pos;
+        const float direction_threshold = 0.7f; // Adjust for tighter/looser direction matching
+        // Ring rays within this many steps of the movement direction pass the direction threshold
+        static const float step_span = std::acos(direction_threshold) / ray_angle_step;
+
+        // Rotate the ring by the actor's yaw once, then only the candidate rays are looked at
+        const float actor_yaw = input.actor_yaw;
+        const float sin_yaw = std::sin(actor_yaw);
+        const float cos_yaw = std::cos(actor_yaw);
+        const float move_step = (std::atan2(input.move_direction.x, input.move_direction.y) - actor_yaw) / ray_angle_step;
+
+        std::vector<DeferredProbe> deferred;
+        // Opposite rays first, deferred forward rays need the opposite reference
+        for (const bool opposite_dir : {true, false})
+        {
+            const float short_length = ShortProbeLength<C>(params, opposite_dir);
+            const float center_step = opposite_dir ? move_step + num_rays / 2.0f : move_step;
+            const float dist_from_player = opposite_dir ? 100.0f : params.ledge_distance;
+            int first = static_cast<int>(std::ceil(center_step - step_span));
+            int last = static_cast<int>(std::floor(center_step + step_span));
+            const int keep = opposite_dir ? 1 : reduced_forward_rays;
+            while (reduced && last - first >= keep)
+            {
+                if (center_step - first > last - center_step)
+                    ++first;
+                else
+                    --last;
+            }
+            for (int k = first; k <= last; ++k)
+            {
+                const int index = ((k % num_rays) + num_rays) % num_rays;
+                const auto &ring_dir = ray_directions[index];
+                const Vec3 normalized_dir(sin_yaw * ring_dir.y + cos_yaw * ring_dir.x,
+                                          cos_yaw * ring_dir.y - sin_yaw * ring_dir.x,
+                                          0.0f);
+                const float yaw = actor_yaw + index * ray_angle_step;
+
+                Vec3 ray_from = actor_pos + (normalized_dir * dist_from_player) + Vec3(0, 0, 80);
+                Vec3 hit_pos;
+                // A forward ray that misses, even only its short phase, ends deeper than drop_threshold
+                bool drop = true;
+                if (context.Cast(ray_from, short_length, hit_pos))
+                {
+                    context.Marker(marker_index, hit_pos);
+                    if (opposite_dir)
+                        op_hit_z.push_back(hit_pos.z);
+                    else
+                        hit_z.push_back(hit_pos.z);
+                    drop = actor_pos.z - hit_pos.z > params.drop_threshold;
+                    if (drop)
+                    {
+                        valid_yaws.push_back(yaw);
+                    }
+                }
+                else if (short_length < ray_length)
+                {
+                    if (opposite_dir)
+                        op_hit_z.push_back(actor_pos.z - params.ground_leeway - 10);
+                    else
+                        deferred.push_back({ray_from - Vec3(0, 0, short_length), yaw});
+                }
+                else
+                {
+                    if (opposite_dir)
+                        op_hit_z.push_back(actor_pos.z - params.drop_threshold - 10);
+                    else
+                        hit_z.push_back(actor_pos.z - params.drop_threshold - 10);
+                }
+                if (!opposite_dir && forward_rays)
+                    forward_rays->push_back({actor_yaw + k * ray_angle_step, drop});
+            }
+        }
+        if (op_hit_z.empty())
+            op_hit_z.push_back(actor_pos.z);
+        ResolveDeferredProbes(context, params, marker_index, actor_pos.z, deferred, hit_z, op_hit_z, &valid_yaws);
+    }
+
+    // Fixed ring of num_rays rays around the actor, only rays aligned with movement are cast. The
+    // reduced ring, for actors and frames that can't afford every ray, still covers the forward sector
+    // with the three rays closest to the movement but takes its reference from a single ray behind.
+    template <class C>
+    bool ProbeRing(C &context, const Params &params, const Input &input, Output &output, bool reduced = false)
+    {
+        output.ledge_lip_distance = 0.0f;
+        int i = 0; // increment into ray markers
+        std::vector<float> valid_yaws;
+        std::vector<float> hit_z;
+        std::vector<float> op_hit_z;
+        CastRing(context, params, input, i, hit_z, op_hit_z, valid_yaws, nullptr, reduced);
+        if (!valid_yaws.empty())
+        {
+            float yaw = AverageAngles(valid_yaws);
+            output.best_yaw = NormalizeAngle(yaw);
+        }
+        if (hit_z.empty())
+            return false;
+        return IsMaxMinZPastDropThreshold(hit_z, op_hit_z, input.actor_pos.z, params);
+    }
+
+    // Coarse-to-fine probing: the coarse pass is the ring's own rays, so it covers the same sector and
+    // decides the same. Only when one of the forward rays finds a drop are extra rays spent bisecting
+    // the edge of the drop in angle between it and a neighbour with support, then the lip of the
+    // ledge in distance. The refining rays only sharpen best_yaw and the lip, never the decision.
+    template <class C>
+    bool ProbeAdaptive(C &context, const Params &params, const Input &input, Output &output)
+    {
+        const Vec3 &actor_pos = input.actor_pos;
+        output.ledge_lip_distance = 0.0f;
+        const float short_length = ShortProbeLength<C>(params, false);
+        int marker_index = 0;
+        std::vector<float> hit_z;
+        std::vector<float> op_hit_z;
+        std::vector<float> valid_yaws;
+        std::vector<RingRay> forward_rays;
+        forward_rays.reserve(4); // At most 4 ring rays pass the direction threshold
+        CastRing(context, params, input, marker_index, hit_z, op_hit_z, valid_yaws, &forward_rays);
+        const bool ledge_detected = IsMaxMinZPastDropThreshold(hit_z, op_hit_z, actor_pos.z, params);
+        if (std::ranges::none_of(forward_rays, &RingRay::drop))
+            return ledge_detected;
+
+        // Casts a refining ray at yaw and distance, returns true if it found a drop.
+        // A miss of the short phase is always a drop, deeper than drop_threshold + ground_leeway.
+        auto probe = [&](float yaw, float distance) {
+            const Vec3 dir_vec(std::sin(yaw), std::cos(yaw), 0.0f);
+            const Vec3 ray_from = actor_pos + (dir_vec * distance) + Vec3(0, 0, 80);
+            Vec3 hit_pos;
+            if (!context.Cast(ray_from, short_length, hit_pos))
+                return true;
+            context.Marker(marker_index, hit_pos);
+            return actor_pos.z - hit_pos.z > params.drop_threshold;
+        };
+
+        // Bisect between neighbouring drop/support rays to find where the drop starts in angle.
+        for (std::size_t r = 0; r + 1 < forward_rays.size(); ++r)
+        {
+            if (forward_rays[r].drop == forward_rays[r + 1].drop)
+                continue;
+            float drop_yaw = forward_rays[r].drop ? forward_rays[r].yaw : forward_rays[r + 1].yaw;
+            float support_yaw = forward_rays[r].drop ? forward_rays[r + 1].yaw : forward_rays[r].yaw;
+            for (int step = 0; step < params.refine_steps; ++step)
+            {
+                const float mid_yaw = (drop_yaw + support_yaw) * 0.5f;
+                if (probe(mid_yaw, params.ledge_distance))
+                    drop_yaw = mid_yaw;
+                else
+                    support_yaw = mid_yaw;
+            }
+            valid_yaws.push_back(drop_yaw);
+        }
+        if (valid_yaws.empty())
+        {
+            for (const auto &ray : forward_rays)
+            {
+                if (ray.drop)
+                    valid_yaws.push_back(ray.yaw);
+            }
+        }
+        output.best_yaw = NormalizeAngle(AverageAngles(valid_yaws));
+
+        // Bisect along the best yaw to find the lip of the ledge.
+        float support_distance = 0.0f;
+        float drop_distance = params.ledge_distance;
+        for (int step = 0; step < params.refine_steps; ++step)
+        {
+            const float mid_distance = (support_distance + drop_distance) * 0.5f;
+            if (probe(output.best_yaw, mid_distance))
+                drop_distance = mid_distance;
+            else
+                support_distance = mid_distance;
+        }
+        output.ledge_lip_distance = drop_distance;
+        return ledge_detected;
+    }
+
+    // The ring's rays plus one slanted pick along the movement direction, which sees a drop straight
+    // ahead that falls between the ring's rays. The pick starts 80 units above the actor, passes the
+    // opposite reference height at ledge_distance and ends drop_threshold below it, so ground in front
+    // that is less than drop_threshold lower stops it. A miss means the ground falls away past
+    // ledge_distance, and only then are vertical rays spent bisecting the lip. The ring's rays keep the
+    // sides and diagonals covered, a pick is a ray and not a shape cast, so it only sees the line it
+    // travels. Every ledge the ring finds is found here too.
+    template <class C>
+    bool ProbeSweep(C &context, const Params &params, const Input &input, Output &output)
+    {
+        const Vec3 &actor_pos = input.actor_pos;
+        const Vec3 &move_direction = input.move_direction;
+        output.ledge_lip_distance = 0.0f;
+        const float short_length = ShortProbeLength<C>(params, false);
+        int marker_index = 0;
+        std::vector<float> hit_z;
+        std::vector<float> op_hit_z;
+        std::vector<float> valid_yaws;
+        CastRing(context, params, input, marker_index, hit_z, op_hit_z, valid_yaws, nullptr);
+        if (!valid_yaws.empty())
+            output.best_yaw = NormalizeAngle(AverageAngles(valid_yaws));
+
+        // Standing too high above the reference already rules out a ledge, no sweep needed
+        const float reference_z = std::min(*std::ranges::max_element(op_hit_z), actor_pos.z);
+        if (reference_z <= actor_pos.z - params.ground_leeway)
+            return false;
+
+        const Vec3 sweep_from = actor_pos + Vec3(0, 0, 80);
+        const float rise = sweep_from.z - reference_z;
+        const float sweep_distance = params.ledge_distance * (rise + params.drop_threshold) / rise;
+        const Vec3 sweep_to(actor_pos.x + move_direction.x * sweep_distance, actor_pos.y + move_direction.y * sweep_distance,
+                            reference_z - params.drop_threshold);
+        Vec3 hit_pos;
+        if (context.Pick(sweep_from, sweep_to, hit_pos))
+        {
+            context.Marker(marker_index, hit_pos);
+            hit_z.push_back(hit_pos.z);
+            return IsMaxMinZPastDropThreshold(hit_z, op_hit_z, actor_pos.z, params);
+        }
+        hit_z.push_back(reference_z - params.drop_threshold - 10);
+        output.best_yaw = NormalizeAngle(std::atan2(move_direction.x, move_direction.y));
+
+        // Bisect along the movement direction to find the lip of the ledge.
+        float support_distance = 0.0f;
+        float drop_distance = params.ledge_distance;
+        for (int step = 0; step < params.refine_steps; ++step)
+        {
+            const float mid_distance = (support_distance + drop_distance) * 0.5f;
+            const Vec3 ray_from = actor_pos + (move_direction * mid_distance) + Vec3(0, 0, 80);
+            if (!context.Cast(ray_from, short_length, hit_pos) || actor_pos.z - hit_pos.z > params.drop_threshold)
+                drop_distance = mid_distance;
+            else
+            {
+                context.Marker(marker_index, hit_pos);
+                support_distance = mid_distance;
+            }
+        }
+        output.ledge_lip_distance = drop_distance;
+        return IsMaxMinZPastDropThreshold(hit_z, op_hit_z, actor_pos.z, params);
+    }
+}
\ No newline at end of file
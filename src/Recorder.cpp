@@ -0,0 +1,136 @@
+namespace Recorder
+{
+    // Checks of the current tick, FinishCheck may run on pool workers
+    std::mutex g_checks_lock;
+    std::unordered_map<RE::FormID, ReplayLog::ActorFrame> g_checks;
+
+    std::uint64_t g_tick_index = 0;
+    std::chrono::steady_clock::time_point g_start;
+
+    // Shared with the writer
+    std::mutex g_queue_lock;
+    std::condition_variable_any g_queue_signal;
+    std::deque<ReplayLog::Tick> g_ticks;
+    std::jthread g_writer;
+
+    ReplayLog::Vec3 ToVec3(const RE::NiPoint3 &point)
+    {
+        return {point.x, point.y, point.z};
+    }
+
+    void WriterLoop(std::stop_token stop_token, std::ofstream out)
+    {
+        ReplayLog::Encoder encoder;
+        std::vector<std::byte> bytes;
+        while (true)
+        {
+            std::deque<ReplayLog::Tick> ticks;
+            {
+                std::unique_lock lock(g_queue_lock);
+                // Whatever is still queued when the game exits is written before stopping
+                if (!g_queue_signal.wait(lock, stop_token, [] { return !g_ticks.empty(); }) && g_ticks.empty())
+                    return;
+                ticks.swap(g_ticks);
+            }
+            bytes.clear();
+            for (auto &tick : ticks)
+                encoder.Encode(std::move(tick), bytes);
+            out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            out.flush();
+        }
+    }
+
+    void Start()
+    {
+        if (g_writer.joinable())
+            return;
+        auto logs_folder = SKSE::log::log_directory();
+        if (!logs_folder)
+        {
+            logger::error("No log directory for the replay log, not recording"sv);
+            return;
+        }
+        const auto path = *logs_folder / "AnimationLedgeBlockNG.replay";
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            logger::error("Couldn't create replay log {}"sv, path.string());
+            return;
+        }
+        const auto &config = Config::Current();
+        ReplayLog::FileHeader file_header;
+        file_header.drop_threshold = config.drop_threshold;
+        file_header.ledge_distance = config.ledge_distance;
+        file_header.ground_leeway = config.ground_leeway;
+        file_header.refine_steps = config.refine_steps;
+        // Far actors and the watchdog may still switch to the reduced ring while recording
+        file_header.kernel = Utils::ReplayKernel();
+        const auto header = ReplayLog::EncodeHeader(file_header);
+        out.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size()));
+        g_start = std::chrono::steady_clock::now();
+        g_writer = std::jthread(WriterLoop, std::move(out));
+        logger::info("Recording ledge checks to {}"sv, path.string());
+    }
+
+    void AddCheck(RE::FormID actor_id, const Utils::ProbeRequest &request, const Utils::ProbeResult &result)
+    {
+        std::scoped_lock lock(g_checks_lock);
+        auto &frame = g_checks[actor_id];
+        frame.flags |= ReplayLog::kChecked;
+        if (request.in_midair)
+            frame.flags |= ReplayLog::kInMidair;
+        if (result.ledge_detected)
+            frame.flags |= ReplayLog::kLedgeDetected;
+        if (request.needs_probe)
+        {
+            frame.flags |= ReplayLog::kProbed;
+            frame.probe_position = ToVec3(request.actor_pos);
+            frame.move_direction = ToVec3(request.move_direction);
+            frame.probe_yaw = request.actor_yaw;
+        }
+        frame.probes.insert(frame.probes.end(), result.probes.begin(), result.probes.end());
+    }
+
+    void EndTick()
+    {
+        if (!g_writer.joinable())
+            return;
+        ReplayLog::Tick tick;
+        tick.index = g_tick_index++;
+        tick.time_us = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - g_start).count());
+        {
+            std::scoped_lock lock(g_checks_lock);
+            for (auto &[actor_id, state] : Globals::g_actor_states)
+            {
+                auto *actor = RE::TESForm::LookupByID<RE::Actor>(actor_id);
+                if (!actor)
+                    continue;
+                ReplayLog::ActorFrame frame;
+                if (const auto it = g_checks.find(actor_id); it != g_checks.end())
+                    frame = std::move(it->second);
+                frame.actor_id = actor_id;
+                frame.position = ToVec3(actor->GetPosition());
+                RE::NiPoint3 velocity;
+                actor->GetLinearVelocity(velocity);
+                frame.velocity = ToVec3(velocity);
+                frame.yaw = actor->GetAngleZ();
+                frame.animation_type = static_cast<std::uint8_t>(state.animation_type);
+                if (state.is_attacking)
+                    frame.flags |= ReplayLog::kAttacking;
+                if (state.is_on_ledge)
+                    frame.flags |= ReplayLog::kOnLedge;
+                if (state.is_jumping)
+                    frame.flags |= ReplayLog::kJumping;
+                if (actor->IsPlayerRef())
+                    frame.flags |= ReplayLog::kPlayer;
+                tick.actors.push_back(std::move(frame));
+            }
+            g_checks.clear();
+        }
+        {
+            std::scoped_lock lock(g_queue_lock);
+            g_ticks.push_back(std::move(tick));
+        }
+        g_queue_signal.notify_one();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+// Records every check tick into a replay log next to the plugin's log file, encoded and written
+// on a background thread.
+namespace Recorder
+{
+    // Opens the log and starts the writer.
+    void Start();
+
+    // Adds a finished check of the actor to the current tick. Safe from the worker pool.
+    void AddCheck(RE::FormID actor_id, const Utils::ProbeRequest &request, const Utils::ProbeResult &result);
+
+    // Adds every tracked actor to the current tick and hands it to the writer.
+    void EndTick();
+}
\ No newline at end of file
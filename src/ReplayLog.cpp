@@ -0,0 +1,250 @@
+#include "ReplayLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ReplayLog
+{
+    std::int64_t ToFixed(float value, float scale)
+    {
+        return static_cast<std::int64_t>(std::llround(static_cast<double>(value) * scale));
+    }
+
+    float FromFixed(std::int64_t value, float scale)
+    {
+        return static_cast<float>(static_cast<double>(value) / scale);
+    }
+
+    void PutVarint(std::vector<std::byte> &out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<std::byte>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::byte>(value));
+    }
+
+    // Zigzag keeps small negative deltas small
+    void PutSigned(std::vector<std::byte> &out, std::int64_t value)
+    {
+        PutVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    // Codes value against previous and leaves previous holding value, both in fixed point.
+    void PutDelta(std::vector<std::byte> &out, float value, std::int64_t &previous, float scale)
+    {
+        const std::int64_t fixed = ToFixed(value, scale);
+        PutSigned(out, fixed - previous);
+        previous = fixed;
+    }
+
+    void PutDelta(std::vector<std::byte> &out, const Vec3 &value, std::int64_t (&previous)[3], float scale)
+    {
+        PutDelta(out, value.x, previous[0], scale);
+        PutDelta(out, value.y, previous[1], scale);
+        PutDelta(out, value.z, previous[2], scale);
+    }
+
+    class Cursor
+    {
+    public:
+        Cursor(std::span<const std::byte> bytes, std::size_t offset) : bytes(bytes), offset(offset) {}
+
+        bool Varint(std::uint64_t &value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (offset >= bytes.size())
+                    return false;
+                const auto byte = static_cast<std::uint64_t>(bytes[offset++]);
+                value |= (byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        bool Signed(std::int64_t &value)
+        {
+            std::uint64_t raw;
+            if (!Varint(raw))
+                return false;
+            value = static_cast<std::int64_t>(raw >> 1) ^ -static_cast<std::int64_t>(raw & 1);
+            return true;
+        }
+
+        bool Delta(float &value, std::int64_t &previous, float scale)
+        {
+            std::int64_t delta;
+            if (!Signed(delta))
+                return false;
+            previous += delta;
+            value = FromFixed(previous, scale);
+            return true;
+        }
+
+        bool Delta(Vec3 &value, std::int64_t (&previous)[3], float scale)
+        {
+            return Delta(value.x, previous[0], scale) && Delta(value.y, previous[1], scale) && Delta(value.z, previous[2], scale);
+        }
+
+        bool Byte(std::uint8_t &value)
+        {
+            if (offset >= bytes.size())
+                return false;
+            value = static_cast<std::uint8_t>(bytes[offset++]);
+            return true;
+        }
+
+        std::size_t Offset() const { return offset; }
+
+    private:
+        std::span<const std::byte> bytes;
+        std::size_t offset;
+    };
+
+    std::vector<std::byte> EncodeHeader(const FileHeader &header)
+    {
+        std::vector<std::byte> out(sizeof(header));
+        std::memcpy(out.data(), &header, sizeof(header));
+        return out;
+    }
+
+    void Encoder::Encode(Tick tick, std::vector<std::byte> &out)
+    {
+        std::ranges::sort(tick.actors, {}, &ActorFrame::actor_id);
+
+        std::vector<std::byte> payload;
+        PutVarint(payload, tick.index - previous_index);
+        PutVarint(payload, tick.time_us - previous_time_us);
+        PutVarint(payload, tick.actors.size());
+        std::uint32_t previous_id = 0;
+        for (const auto &actor : tick.actors)
+        {
+            PutVarint(payload, actor.actor_id - previous_id);
+            previous_id = actor.actor_id;
+            // An actor seen for the first time is coded against zero
+            auto &last = previous[actor.actor_id];
+            PutDelta(payload, actor.position, last.position, position_scale);
+            PutDelta(payload, actor.velocity, last.velocity, position_scale);
+            PutDelta(payload, actor.yaw, last.yaw, yaw_scale);
+            payload.push_back(static_cast<std::byte>(actor.animation_type));
+            payload.push_back(static_cast<std::byte>(actor.flags));
+            if (!(actor.flags & kChecked))
+                continue;
+            if (actor.flags & kProbed)
+            {
+                // The check began a moment before the tick ended, its inputs are close to the actor's
+                std::int64_t position[3] = {last.position[0], last.position[1], last.position[2]};
+                std::int64_t direction[3] = {};
+                std::int64_t yaw = last.yaw;
+                PutDelta(payload, actor.probe_position, position, position_scale);
+                PutDelta(payload, actor.move_direction, direction, fraction_scale);
+                PutDelta(payload, actor.probe_yaw, yaw, yaw_scale);
+            }
+            PutVarint(payload, actor.probes.size());
+            for (const auto &probe : actor.probes)
+            {
+                // Picks start near the actor and mostly run straight down, both ends code short
+                std::int64_t from[3] = {last.position[0], last.position[1], last.position[2]};
+                PutDelta(payload, probe.from, from, position_scale);
+                PutDelta(payload, probe.to, from, position_scale);
+                // Misses are the common case on flat ground, they code as zero
+                PutVarint(payload, static_cast<std::uint64_t>(std::clamp<std::int64_t>(ToFixed(1.0f - probe.hit_fraction, fraction_scale), 0,
+                                                                                      static_cast<std::int64_t>(fraction_scale))));
+            }
+        }
+        previous_index = tick.index;
+        previous_time_us = tick.time_us;
+
+        PutVarint(out, payload.size());
+        out.insert(out.end(), payload.begin(), payload.end());
+    }
+
+    bool Decoder::Open(std::span<const std::byte> file_bytes)
+    {
+        if (file_bytes.size() < sizeof(header))
+            return false;
+        std::memcpy(&header, file_bytes.data(), sizeof(header));
+        if (header.magic != file_magic || header.version != file_version)
+        {
+            header = {};
+            return false;
+        }
+        bytes = file_bytes;
+        offset = sizeof(header);
+        previous.clear();
+        previous_index = 0;
+        previous_time_us = 0;
+        return true;
+    }
+
+    bool Decoder::Next(Tick &tick)
+    {
+        Cursor length_cursor(bytes, offset);
+        std::uint64_t length;
+        if (!length_cursor.Varint(length) || length > bytes.size() - length_cursor.Offset())
+            return false;
+        const std::size_t end = length_cursor.Offset() + static_cast<std::size_t>(length);
+
+        // Decoded into copies, a bad record leaves the decoder as it was
+        auto actors_previous = previous;
+        Cursor cursor(bytes.first(end), length_cursor.Offset());
+        std::uint64_t index_delta, time_delta, actor_count;
+        if (!cursor.Varint(index_delta) || !cursor.Varint(time_delta) || !cursor.Varint(actor_count))
+            return false;
+        tick.index = previous_index + index_delta;
+        tick.time_us = previous_time_us + time_delta;
+        tick.actors.clear();
+        std::uint32_t previous_id = 0;
+        for (std::uint64_t a = 0; a < actor_count; ++a)
+        {
+            ActorFrame actor;
+            std::uint64_t id_delta;
+            if (!cursor.Varint(id_delta))
+                return false;
+            actor.actor_id = previous_id + static_cast<std::uint32_t>(id_delta);
+            previous_id = actor.actor_id;
+            auto &last = actors_previous[actor.actor_id];
+            if (!cursor.Delta(actor.position, last.position, position_scale) || !cursor.Delta(actor.velocity, last.velocity, position_scale) ||
+                !cursor.Delta(actor.yaw, last.yaw, yaw_scale) || !cursor.Byte(actor.animation_type) || !cursor.Byte(actor.flags))
+                return false;
+            if (actor.flags & kChecked)
+            {
+                if (actor.flags & kProbed)
+                {
+                    std::int64_t position[3] = {last.position[0], last.position[1], last.position[2]};
+                    std::int64_t direction[3] = {};
+                    std::int64_t yaw = last.yaw;
+                    if (!cursor.Delta(actor.probe_position, position, position_scale) || !cursor.Delta(actor.move_direction, direction, fraction_scale) ||
+                        !cursor.Delta(actor.probe_yaw, yaw, yaw_scale))
+                        return false;
+                }
+                std::uint64_t probe_count;
+                if (!cursor.Varint(probe_count))
+                    return false;
+                for (std::uint64_t p = 0; p < probe_count; ++p)
+                {
+                    Probe probe;
+                    std::int64_t from[3] = {last.position[0], last.position[1], last.position[2]};
+                    std::uint64_t miss_fraction;
+                    if (!cursor.Delta(probe.from, from, position_scale) || !cursor.Delta(probe.to, from, position_scale) || !cursor.Varint(miss_fraction))
+                        return false;
+                    probe.hit_fraction = 1.0f - FromFixed(static_cast<std::int64_t>(miss_fraction), fraction_scale);
+                    actor.probes.push_back(probe);
+                }
+            }
+            tick.actors.push_back(std::move(actor));
+        }
+        if (cursor.Offset() != end)
+            return false;
+        previous = std::move(actors_previous);
+        previous_index = tick.index;
+        previous_time_us = tick.time_us;
+        offset = end;
+        return true;
+    }
+}
\ No newline at end of file
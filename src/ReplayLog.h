@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// Replay log of ledge checks: per tick, every tracked actor's motion and animation state and, for
+// the actors checked that tick, each pick and the decision. Written by the plugin, read by the tools.
+// Records are varint packed, values are fixed point and delta coded against the actor's previous
+// record. No game headers here, this file is also built into the tools.
+namespace ReplayLog
+{
+    constexpr std::uint32_t file_magic = 0x50524C41; // "ALRP"
+    constexpr std::uint32_t file_version = 3;
+
+    constexpr float position_scale = 256.0f;     // Fixed point steps per unit
+    constexpr float yaw_scale = 65536.0f;        // Fixed point steps per radian
+    constexpr float fraction_scale = 1048576.0f; // Fixed point steps of a whole pick, and of a unit direction
+
+    // The probe kernel selected when recording began, a variant flag may be added to any of them.
+    enum Kernel : std::uint32_t
+    {
+        kRingKernel = 0,
+        kAdaptiveKernel = 1,
+        kSweepKernel = 2,
+        kReducedKernel = 3, // The ring with fewer rays, of the watchdog's fewer rays level
+        kTwoPhaseKernel = 1 << 8
+    };
+
+    // Starts the file, with the probe tuning and kernel the recording began with.
+    struct FileHeader
+    {
+        std::uint32_t magic = file_magic;
+        std::uint32_t version = file_version;
+        float drop_threshold = 0.0f;
+        float ledge_distance = 0.0f;
+        float ground_leeway = 0.0f;
+        std::int32_t refine_steps = 0;
+        std::uint32_t kernel = kRingKernel;
+    };
+
+    static_assert(sizeof(FileHeader) == 28);
+
+    struct Vec3
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+    };
+
+    // One pick, hit_fraction is 1 for a miss.
+    struct Probe
+    {
+        Vec3 from;
+        Vec3 to;
+        float hit_fraction = 1.0f;
+    };
+
+    enum ActorFlags : std::uint8_t
+    {
+        kAttacking = 1 << 0,
+        kOnLedge = 1 << 1, // After this tick's check
+        kJumping = 1 << 2,
+        kInMidair = 1 << 3,
+        kChecked = 1 << 4, // The actor's probes and decision are recorded
+        kLedgeDetected = 1 << 5,
+        kPlayer = 1 << 6,
+        kProbed = 1 << 7 // The check cast rays, its probe input is recorded
+    };
+
+    struct ActorFrame
+    {
+        std::uint32_t actor_id = 0;
+        Vec3 position;
+        Vec3 velocity;
+        float yaw = 0.0f;
+        std::uint8_t animation_type = 0;
+        std::uint8_t flags = 0;
+        // What the probes were given, taken when the check began
+        Vec3 probe_position;
+        Vec3 move_direction;
+        float probe_yaw = 0.0f;
+        std::vector<Probe> probes;
+    };
+
+    struct Tick
+    {
+        std::uint64_t index = 0;
+        std::uint64_t time_us = 0; // Since recording started
+        std::vector<ActorFrame> actors;
+    };
+
+    // Fixed point values an actor's next record is coded against.
+    struct FixedFrame
+    {
+        std::int64_t position[3] = {};
+        std::int64_t velocity[3] = {};
+        std::int64_t yaw = 0;
+    };
+
+    std::vector<std::byte> EncodeHeader(const FileHeader &header);
+
+    // Keeps every actor's last record, ticks must be encoded in order.
+    class Encoder
+    {
+    public:
+        // Appends the tick's record, prefixed with its length.
+        void Encode(Tick tick, std::vector<std::byte> &out);
+
+    private:
+        std::unordered_map<std::uint32_t, FixedFrame> previous;
+        std::uint64_t previous_index = 0;
+        std::uint64_t previous_time_us = 0;
+    };
+
+    class Decoder
+    {
+    public:
+        // Checks the header. False if the bytes aren't a replay log of this version.
+        bool Open(std::span<const std::byte> bytes);
+
+        const FileHeader &Header() const { return header; }
+
+        // Decodes the next record, false at the end or at a torn or corrupt record.
+        bool Next(Tick &tick);
+
+    private:
+        FileHeader header;
+        std::span<const std::byte> bytes;
+        std::size_t offset = 0;
+        std::unordered_map<std::uint32_t, FixedFrame> previous;
+        std::uint64_t previous_index = 0;
+        std::uint64_t previous_time_us = 0;
+    };
+}
\ No newline at end of file
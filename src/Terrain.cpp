@@ -0,0 +1,216 @@
+namespace Terrain
+{
+    constexpr float cell_size = 4096.0f;
+    constexpr int grid_squares = 32; // Land vertices are 128 units apart
+    constexpr int grid_vertices = grid_squares + 1;
+    constexpr float square_size = cell_size / grid_squares;
+
+    struct HeightGrid
+    {
+        RE::FormID cell_id = 0;
+        std::int32_t cell_x = 0;
+        std::int32_t cell_y = 0;
+        std::array<float, grid_vertices * grid_vertices> heights{};
+        std::array<bool, grid_squares * grid_squares> covered{}; // Statics above the land, needs a real ray
+    };
+
+    // Changed on the main thread only, asynchronous probes sample it from their thread
+    std::shared_mutex g_grids_lock;
+    std::unordered_map<std::uint64_t, HeightGrid> g_grids;
+    RE::TESWorldSpace *g_worldspace = nullptr;
+
+    std::uint64_t CellKey(std::int32_t cell_x, std::int32_t cell_y)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell_x)) << 32) | static_cast<std::uint32_t>(cell_y);
+    }
+
+    // World space box around a reference's rotated and scaled bounds.
+    struct Bounds
+    {
+        RE::NiPoint3 min;
+        RE::NiPoint3 max;
+    };
+
+    bool GetWorldBounds(RE::TESObjectREFR *ref, Bounds &bounds)
+    {
+        const auto *node = ref->Get3D();
+        if (!node)
+            return false;
+        const auto &world = node->world;
+        const RE::NiPoint3 local_min = ref->GetBoundMin();
+        const RE::NiPoint3 local_max = ref->GetBoundMax();
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        bounds = {{inf, inf, inf}, {-inf, -inf, -inf}};
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const float local[3] = {(corner & 1) ? local_max.x : local_min.x, (corner & 2) ? local_max.y : local_min.y,
+                                    (corner & 4) ? local_max.z : local_min.z};
+            float out[3];
+            for (int row = 0; row < 3; ++row)
+                out[row] = (world.rotate.entry[row][0] * local[0] + world.rotate.entry[row][1] * local[1] + world.rotate.entry[row][2] * local[2]) * world.scale;
+            const RE::NiPoint3 point(world.translate.x + out[0], world.translate.y + out[1], world.translate.z + out[2]);
+            bounds.min = RE::NiPoint3(std::min(bounds.min.x, point.x), std::min(bounds.min.y, point.y), std::min(bounds.min.z, point.z));
+            bounds.max = RE::NiPoint3(std::max(bounds.max.x, point.x), std::max(bounds.max.y, point.y), std::max(bounds.max.z, point.z));
+        }
+        return true;
+    }
+
+    // Marks the grid's squares where the bounds reach above the land.
+    void MarkCovered(HeightGrid &grid, const Bounds &bounds)
+    {
+        const float origin_x = grid.cell_x * cell_size;
+        const float origin_y = grid.cell_y * cell_size;
+        if (bounds.max.x < origin_x || bounds.min.x > origin_x + cell_size || bounds.max.y < origin_y || bounds.min.y > origin_y + cell_size)
+            return;
+        const int min_x = std::clamp(static_cast<int>(std::floor((bounds.min.x - origin_x) / square_size)), 0, grid_squares - 1);
+        const int max_x = std::clamp(static_cast<int>(std::floor((bounds.max.x - origin_x) / square_size)), 0, grid_squares - 1);
+        const int min_y = std::clamp(static_cast<int>(std::floor((bounds.min.y - origin_y) / square_size)), 0, grid_squares - 1);
+        const int max_y = std::clamp(static_cast<int>(std::floor((bounds.max.y - origin_y) / square_size)), 0, grid_squares - 1);
+        for (int y = min_y; y <= max_y; ++y)
+        {
+            for (int x = min_x; x <= max_x; ++x)
+            {
+                const float lowest = std::min({grid.heights[y * grid_vertices + x], grid.heights[y * grid_vertices + x + 1],
+                                               grid.heights[(y + 1) * grid_vertices + x], grid.heights[(y + 1) * grid_vertices + x + 1]});
+                if (bounds.max.z >= lowest)
+                    grid.covered[y * grid_squares + x] = true;
+            }
+        }
+    }
+
+    // Bounds of the statics in the cell, everything but actors and unloaded references.
+    std::vector<Bounds> CollectBounds(RE::TESObjectCELL *cell)
+    {
+        std::vector<Bounds> all_bounds;
+        cell->ForEachReference([&](RE::TESObjectREFR *ref) {
+            Bounds bounds;
+            if (ref && !ref->As<RE::Actor>() && GetWorldBounds(ref, bounds))
+                all_bounds.push_back(bounds);
+            return RE::BSContainer::ForEachResult::kContinue;
+        });
+        return all_bounds;
+    }
+
+    void BuildGrid(RE::TESObjectCELL *cell)
+    {
+        if (!cell || !cell->IsExteriorCell())
+            return;
+        auto *coordinates = cell->GetCoordinates();
+        auto *tes = RE::TES::GetSingleton();
+        if (!coordinates || !tes)
+            return;
+
+        auto *worldspace = cell->GetRuntimeData().worldSpace;
+        if (worldspace != g_worldspace)
+        {
+            std::unique_lock lock(g_grids_lock);
+            g_grids.clear();
+            g_worldspace = worldspace;
+        }
+
+        HeightGrid grid;
+        grid.cell_id = cell->GetFormID();
+        const float origin_x = coordinates->cellX * cell_size;
+        const float origin_y = coordinates->cellY * cell_size;
+        for (int y = 0; y < grid_vertices; ++y)
+        {
+            for (int x = 0; x < grid_vertices; ++x)
+            {
+                const RE::NiPoint3 vertex_pos(origin_x + x * square_size, origin_y + y * square_size, 65536.0f);
+                if (!tes->GetLandHeight(vertex_pos, grid.heights[y * grid_vertices + x]))
+                {
+                    logger::debug("Could not sample land height of cell {:X}, no terrain grid"sv, grid.cell_id);
+                    return;
+                }
+            }
+        }
+
+        // Mark the squares that have something other than land to stand on. References of the
+        // neighbouring cells can overhang the border, and this cell's can overhang into theirs.
+        grid.cell_x = coordinates->cellX;
+        grid.cell_y = coordinates->cellY;
+        const auto own_bounds = CollectBounds(cell);
+        for (const auto &bounds : own_bounds)
+            MarkCovered(grid, bounds);
+        tes->ForEachCell([&](RE::TESObjectCELL *neighbour) {
+            if (!neighbour || neighbour == cell || !neighbour->IsExteriorCell() || neighbour->GetRuntimeData().worldSpace != worldspace)
+                return;
+            const auto *neighbour_coordinates = neighbour->GetCoordinates();
+            if (!neighbour_coordinates || std::abs(neighbour_coordinates->cellX - grid.cell_x) > 1 || std::abs(neighbour_coordinates->cellY - grid.cell_y) > 1)
+                return;
+            for (const auto &bounds : CollectBounds(neighbour))
+                MarkCovered(grid, bounds);
+        });
+
+        {
+            std::unique_lock lock(g_grids_lock);
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    const auto it = (dx || dy) ? g_grids.find(CellKey(grid.cell_x + dx, grid.cell_y + dy)) : g_grids.end();
+                    if (it == g_grids.end())
+                        continue;
+                    for (const auto &bounds : own_bounds)
+                        MarkCovered(it->second, bounds);
+                }
+            }
+            g_grids[CellKey(grid.cell_x, grid.cell_y)] = grid;
+        }
+        logger::debug("Built terrain grid for cell {:X} ({}, {})"sv, grid.cell_id, coordinates->cellX, coordinates->cellY);
+    }
+
+    void EnsureGrid(RE::TESObjectCELL *cell)
+    {
+        if (!cell || !cell->IsExteriorCell())
+            return;
+        auto *coordinates = cell->GetCoordinates();
+        if (!coordinates)
+            return;
+        if (cell->GetRuntimeData().worldSpace == g_worldspace && g_grids.contains(CellKey(coordinates->cellX, coordinates->cellY)))
+            return;
+        BuildGrid(cell);
+    }
+
+    void EvictDetachedCells()
+    {
+        std::unique_lock lock(g_grids_lock);
+        for (auto it = g_grids.begin(); it != g_grids.end();)
+        {
+            const auto cell = RE::TESForm::LookupByID<RE::TESObjectCELL>(it->second.cell_id);
+            if (!cell || !cell->IsAttached())
+                it = g_grids.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    bool SampleHeight(RE::TESWorldSpace *worldspace, const RE::NiPoint3 &pos, float &height)
+    {
+        std::shared_lock lock(g_grids_lock);
+        if (g_grids.empty() || !worldspace || worldspace != g_worldspace)
+            return false;
+        const auto cell_x = static_cast<std::int32_t>(std::floor(pos.x / cell_size));
+        const auto cell_y = static_cast<std::int32_t>(std::floor(pos.y / cell_size));
+        const auto it = g_grids.find(CellKey(cell_x, cell_y));
+        if (it == g_grids.end())
+            return false;
+        const HeightGrid &grid = it->second;
+
+        const float grid_x = (pos.x - cell_x * cell_size) / square_size;
+        const float grid_y = (pos.y - cell_y * cell_size) / square_size;
+        const int x = std::clamp(static_cast<int>(grid_x), 0, grid_squares - 1);
+        const int y = std::clamp(static_cast<int>(grid_y), 0, grid_squares - 1);
+        if (grid.covered[y * grid_squares + x])
+            return false;
+
+        const float tx = grid_x - x;
+        const float ty = grid_y - y;
+        const float h00 = grid.heights[y * grid_vertices + x];
+        const float h10 = grid.heights[y * grid_vertices + x + 1];
+        const float h01 = grid.heights[(y + 1) * grid_vertices + x];
+        const float h11 = grid.heights[(y + 1) * grid_vertices + x + 1];
+        height = (h00 * (1.0f - tx) + h10 * tx) * (1.0f - ty) + (h01 * (1.0f - tx) + h11 * tx) * ty;
+        return true;
+    }
+}
\ No newline at end of file
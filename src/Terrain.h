@@ -0,0 +1,16 @@
+#pragma once
+
+namespace Terrain
+{
+    // Samples the land heights of a loaded exterior cell into a grid, once per cell.
+    void BuildGrid(RE::TESObjectCELL *cell);
+
+    // Builds the cell's grid if it doesn't have one yet.
+    void EnsureGrid(RE::TESObjectCELL *cell);
+
+    void EvictDetachedCells();
+
+    // Bilinear land height under pos in the worldspace, nullptr for an interior. False if there is no grid
+    // for it or statics cover that part of the land. Reads no game data, safe off the main thread.
+    bool SampleHeight(RE::TESWorldSpace *worldspace, const RE::NiPoint3 &pos, float &height);
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "AnimationTags.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+// What the event sinks and ledge checks do to an actor's state: tracking on combat changes, moves
+// started and ended by animation events, which actors a tick checks and what a decision leaves
+// behind. Templates over the state, Globals::ActorState in the plugin and a plain copy in the tools,
+// so both run the same rules. No game headers here, this file is also built into the tools.
+namespace Tracking
+{
+    // Only the newest safe point is ever used, older ones are kept for a few ticks of slack.
+    constexpr std::size_t max_safe_points = 8;
+
+    // RE::ACTOR_COMBAT_STATE.
+    enum class CombatState
+    {
+        kNone = 0,
+        kCombat = 1,
+        kSearching = 2
+    };
+
+    enum class CombatChange
+    {
+        kNone,
+        kTrack,  // Entered combat untracked
+        kUntrack // Left combat tracked
+    };
+
+    // What a combat event means for the actor. Searching keeps things as they are.
+    inline CombatChange OnCombatEvent(bool tracked, CombatState state)
+    {
+        if (state == CombatState::kCombat && !tracked)
+            return CombatChange::kTrack;
+        if (state == CombatState::kNone && tracked)
+            return CombatChange::kUntrack;
+        return CombatChange::kNone;
+    }
+
+    enum class AnimationChange
+    {
+        kNone,
+        kStarted,
+        kEnded,
+        kJumped
+    };
+
+    // Applies a tracked actor's animation event. now is stored as the jump start, in the caller's clock.
+    template <class State, class Time>
+    AnimationChange OnAnimationEvent(State &state, std::string_view tag, std::string_view payload, const AnimationTags::Toggles &toggles, Time now)
+    {
+        if (const auto start_type = AnimationTags::StartType(tag, toggles); start_type != AnimationTags::kNone)
+        {
+            state.is_attacking = true;
+            state.safe_grounded_positions.clear();
+            state.animation_type = start_type;
+            return AnimationChange::kStarted;
+        }
+        if (AnimationTags::IsEnd(state.animation_type, state.is_attacking, tag, payload))
+        {
+            state.animation_type = AnimationTags::kNone;
+            state.is_attacking = false;
+            state.is_on_ledge = false;
+            return AnimationChange::kEnded;
+        }
+        if (!state.is_attacking && tag == "JumpUp")
+        {
+            state.jump_start = now;
+            state.is_jumping = true;
+            return AnimationChange::kJumped;
+        }
+        return AnimationChange::kNone;
+    }
+
+    // Whether the actor is due a check this tick: not mid jump, and in a move or still near a ledge.
+    // Ends a jump that lasted jump_duration seconds.
+    template <class State>
+    bool WantsCheck(State &state, float seconds_since_jump, float jump_duration)
+    {
+        if (state.is_jumping && jump_duration > seconds_since_jump)
+            return false;
+        state.is_jumping = false;
+        return state.is_attacking || state.is_on_ledge;
+    }
+
+    // Remembers a check's decision: a found ledge, or the checked position as the next safe point.
+    template <class State, class Point>
+    void RecordDecision(State &state, int memory_duration, bool ledge_detected, bool grounded, const Point &pos)
+    {
+        ++state.loops;
+        if (ledge_detected || state.loops > memory_duration)
+        {
+            state.is_on_ledge = ledge_detected;
+            state.loops = 0;
+        }
+        if (!ledge_detected && grounded)
+        {
+            auto &points = state.safe_grounded_positions;
+            if (points.size() >= max_safe_points)
+                points.erase(points.begin());
+            points.push_back(pos);
+        }
+    }
+
+    // The newest safe point if it is within valid_distance of pos, else nullptr and the actor steps back.
+    template <class State, class Point>
+    const Point *NearSafePoint(const State &state, const Point &pos, float valid_distance)
+    {
+        if (state.safe_grounded_positions.empty())
+            return nullptr;
+        const Point &back = state.safe_grounded_positions.back();
+        const float dx = back.x - pos.x;
+        const float dy = back.y - pos.y;
+        const float dz = back.z - pos.z;
+        return dx * dx + dy * dy + dz * dz <= valid_distance * valid_distance ? &back : nullptr;
+    }
+
+    // How far an actor without a safe point steps back: until a located lip is half the probe
+    // distance ahead, at least 4 units.
+    template <class State>
+    float BackOff(const State &state, float ledge_distance)
+    {
+        const float lip_clearance = ledge_distance * 0.5f;
+        return state.ledge_lip_distance > 0.0f ? std::max(4.0f, lip_clearance - state.ledge_lip_distance) : 4.0f;
+    }
+
+    // CleanupActors' sweep: every state keep(form_id) turns down is removed through untrack(it),
+    // which returns the next iterator. Returns how many states it visited.
+    template <class Map, class Keep, class Untrack>
+    std::size_t SweepStates(Map &states, Keep keep, Untrack untrack)
+    {
+        std::size_t visited = 0;
+        for (auto it = states.begin(); it != states.end(); ++visited)
+        {
+            if (keep(it->first))
+                ++it;
+            else
+                it = untrack(it);
+        }
+        return visited;
+    }
+}
\ No newline at end of file
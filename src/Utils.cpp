@@ -52,25 +52,20 @@ namespace Utils
 
     void CleanupActors()
     {
-        for (auto it = Globals::g_actor_states.begin(); it != Globals::g_actor_states.end();)
-        {
-            if (const auto actor = RE::TESForm::LookupByID<RE::Actor>(it->first); !actor || actor->IsDead() || actor->IsDeleted() || !actor->IsInCombat() || actor->IsDisabled())
-            {
-                if (actor->IsPlayerRef())
-                {
-                    ++it;
-                    continue;
-                }
+        const auto keep = [](RE::FormID form_id) {
+            const auto actor = RE::TESForm::LookupByID<RE::Actor>(form_id);
+            return actor && (actor->IsPlayerRef() || (!actor->IsDead() && !actor->IsDeleted() && actor->IsInCombat() && !actor->IsDisabled()));
+        };
+        Tracking::SweepStates(Globals::g_actor_states, keep, [](auto it) {
+            const auto actor = RE::TESForm::LookupByID<RE::Actor>(it->first);
+            if (actor && !Globals::global_animation_hook)
                 actor->RemoveAnimationGraphEventSink(Events::AttackAnimationGraphEventSink::GetSingleton());
-                it = Globals::g_actor_states.erase(it);
-            }
-            else
-                ++it;
-        }
+            return Globals::UntrackActor(it);
+        });
     }
 
     // Force the actor to stop moving toward their original vector
-    void MoveActorToSafePoint(RE::Actor *actor, Globals::ActorState &state)
+    void MoveActorToSafePoint(RE::Actor *actor, Globals::ActorState &state, const Config::Snapshot &config)
     {
         Globals::ActorState *stateCheck = Globals::CheckState(actor);
         if (!stateCheck || !actor)
@@ -86,30 +81,277 @@ namespace Utils
 
         logger::trace("Moving actor {} to safe point"sv, actor->GetName());
 
-        bool teleported = false;
-        if (!state.safe_grounded_positions.empty())
+        const RE::NiPoint3 pos = actor->GetPosition();
+        if (const auto *safe_point = Tracking::NearSafePoint(state, pos, config.valid_safe_point_distance))
         {
-            auto back_pos = state.safe_grounded_positions.back();
-            auto actor_pos = actor->GetPosition();
-            float distance = actor_pos.GetDistance(back_pos);
-            if (distance <= Globals::valid_safe_point_distance)
-            {
-                if (distance > 3.0f)
-                    actor->SetPosition(back_pos, true);
-                teleported = true;
-            }
+            if (pos.GetDistance(*safe_point) > 3.0f)
+                actor->SetPosition(*safe_point, true);
         }
-        if (!teleported)
+        else
         {
-            const RE::NiPoint3 pos = actor->GetPosition();
             const RE::NiPoint3 dir_vec(std::sin(state.best_yaw), std::cos(state.best_yaw), 0.0f);
-            const RE::NiPoint3 back_pos = pos - (dir_vec * 4.0f);
+            const RE::NiPoint3 back_pos = pos - (dir_vec * Tracking::BackOff(state, config.ledge_distance));
             actor->SetPosition(back_pos, true);
         }
     }
 
-    bool IsLedgeAhead(RE::Actor *actor, Globals::ActorState &state)
+    // Per-ray options, the probes are compiled once for every combination so the ray loops don't test them.
+    enum ProbeFeature : std::uint32_t
+    {
+        kShowMarkers = 1 << 0,
+        kTwoPhaseRays = 1 << 1,
+        kTerrainFastPath = 1 << 2,
+        kAdaptiveRays = 1 << 3,
+        kSweepProbe = 1 << 4,
+        kReducedRing = 1 << 5,
+        kProbeFeatureCount = 1 << 6
+    };
+
+    // Set while a check runs off the main thread, changes to the world are queued here instead of made
+    thread_local std::vector<Command> *g_commands = nullptr;
+
+    // Set while a probe runs, the checked actor's filter computed by BeginCheck
+    thread_local const RE::CFilter *g_pick_filter = nullptr;
+
+    // Set while a probe runs and a replay is recorded
+    thread_local std::vector<ReplayLog::Probe> *g_probe_log = nullptr;
+
+    // Records a pick with the hit it settled on, as a fraction of the segment.
+    void LogProbe(const RE::NiPoint3 &ray_from, const RE::NiPoint3 &ray_to, bool hit, const RE::NiPoint3 &hit_pos)
+    {
+        if (!g_probe_log)
+            return;
+        const RE::NiPoint3 delta = ray_to - ray_from;
+        const float length_sq = delta.Dot(delta);
+        const float hit_fraction = hit && length_sq > 0.0f ? std::clamp((hit_pos - ray_from).Dot(delta) / length_sq, 0.0f, 1.0f) : 1.0f;
+        g_probe_log->push_back({{ray_from.x, ray_from.y, ray_from.z}, {ray_to.x, ray_to.y, ray_to.z}, hit_fraction});
+    }
+
+    void ApplyCommand(const Command &command)
+    {
+        if (command.type == Command::Type::kMoveMarker)
+            command.marker->SetPosition(command.pos.x, command.pos.y, command.pos.z + 20);
+        else if (command.type == Command::Type::kRecordDecision)
+            Tracking::RecordDecision(*command.state, command.config->memory_duration, command.ledge_detected, command.grounded, command.pos);
+        else
+            MoveActorToSafePoint(command.actor, *command.state, *command.config);
+    }
+
+    // Moves a debug marker to a probe's hit position, if markers are enabled.
+    template <std::uint32_t F>
+    void PlaceRayMarker(Globals::ActorState &state, int &marker_index, const RE::NiPoint3 &hit_pos)
+    {
+        if constexpr ((F & kShowMarkers) != 0) // if in debug mode move objects to ray hit positions
+        {
+            if (marker_index < static_cast<int>(state.ray_markers.size()))
+            {
+                if (auto marker = state.ray_markers[marker_index]; marker)
+                {
+                    if (g_commands)
+                        g_commands->push_back({Command::Type::kMoveMarker, nullptr, nullptr, marker, hit_pos});
+                    else
+                        marker->SetPosition(hit_pos.x, hit_pos.y, hit_pos.z + 20);
+                }
+            }
+            ++marker_index;
+        }
+    }
+
+    // The actor's collision filter on the line of sight layer.
+    RE::CFilter GetPickFilter(RE::Actor *actor)
+    {
+        RE::CFilter cFilter;
+        actor->GetCollisionFilterInfo(cFilter);
+        cFilter.SetCollisionLayer(RE::COL_LAYER::kLineOfSight);
+        return cFilter;
+    }
+
+    bool CastPick(RE::bhkWorld *bhk_world, RE::Actor *actor, const RE::NiPoint3 &ray_from, const RE::NiPoint3 &ray_to, RE::NiPoint3 &hit_pos)
+    {
+        // Reused by every pick of the thread, only the ends, filter and output change
+        static thread_local RE::bhkPickData ray;
+        const auto havok_world_scale = RE::bhkWorld::GetWorldScale();
+        ray.rayInput.from = ray_from * havok_world_scale;
+        ray.rayInput.to = ray_to * havok_world_scale;
+        ray.rayInput.filterInfo = g_pick_filter ? *g_pick_filter : GetPickFilter(actor);
+        ray.rayOutput.Reset();
+
+        if (!bhk_world->PickObject(ray) || !ray.rayOutput.HasHit())
+            return false;
+
+        auto hitOwner = ray.rayOutput.rootCollidable->GetOwner<RE::hkpRigidBody>();
+        RE::NiPoint3 delta = ray_to - ray_from;
+        hit_pos = ray_from + delta * ray.rayOutput.hitFraction;
+        if (hitOwner)
+        {
+            const auto body = Globals::rigid_body_cache ? BodyCache::Lookup(hitOwner) : BodyCache::Describe(hitOwner);
+            if (body.is_plant && body.ref_pos.z < hit_pos.z)
+                hit_pos = body.ref_pos;
+        }
+        return true;
+    }
+
+    // Picks along the segment from ray_from to ray_to with the actor's collision filter. Returns false if
+    // nothing was hit, otherwise hit_pos is the hit (the base of the reference for Flora/Trees).
+    bool PickSegment(RE::bhkWorld *bhk_world, RE::Actor *actor, const RE::NiPoint3 &ray_from, const RE::NiPoint3 &ray_to, RE::NiPoint3 &hit_pos)
+    {
+        const bool hit = CastPick(bhk_world, actor, ray_from, ray_to, hit_pos);
+        LogProbe(ray_from, ray_to, hit, hit_pos);
+        return hit;
+    }
+
+    // Casts a vertical ray of ray_length down from ray_from. Returns false if nothing was hit,
+    // otherwise hit_pos is the ground position (the base of the reference for Flora/Trees).
+    template <std::uint32_t F>
+    bool CastProbe(RE::bhkWorld *bhk_world, RE::Actor *actor, RE::TESWorldSpace *worldspace, const RE::NiPoint3 &ray_from, float ray_length, RE::NiPoint3 &hit_pos)
+    {
+        if constexpr ((F & kTerrainFastPath) != 0)
+        {
+            float terrain_z;
+            if (Terrain::SampleHeight(worldspace, ray_from, terrain_z) && terrain_z <= ray_from.z)
+            {
+                const RE::NiPoint3 ray_to = ray_from + RE::NiPoint3(0, 0, -ray_length);
+                if (terrain_z < ray_to.z)
+                {
+                    LogProbe(ray_from, ray_to, false, hit_pos);
+                    return false;
+                }
+                hit_pos = RE::NiPoint3(ray_from.x, ray_from.y, terrain_z);
+                LogProbe(ray_from, ray_to, true, hit_pos);
+                return true;
+            }
+        }
+        return PickSegment(bhk_world, actor, ray_from, ray_from + RE::NiPoint3(0, 0, -ray_length), hit_pos);
+    }
+
+    // Answers the portable probes' rays from the physics world, placing the actor's debug markers.
+    template <std::uint32_t F>
+    struct ProbeContext
+    {
+        static constexpr bool two_phase_rays = (F & kTwoPhaseRays) != 0;
+
+        RE::bhkWorld *bhk_world;
+        RE::Actor *actor;
+        RE::TESWorldSpace *worldspace;
+        Globals::ActorState &state;
+
+        bool Cast(const LedgeProbes::Vec3 &from, float length, LedgeProbes::Vec3 &hit)
+        {
+            RE::NiPoint3 hit_pos;
+            if (!CastProbe<F>(bhk_world, actor, worldspace, RE::NiPoint3(from.x, from.y, from.z), length, hit_pos))
+                return false;
+            hit = {hit_pos.x, hit_pos.y, hit_pos.z};
+            return true;
+        }
+
+        bool Pick(const LedgeProbes::Vec3 &from, const LedgeProbes::Vec3 &to, LedgeProbes::Vec3 &hit)
+        {
+            RE::NiPoint3 hit_pos;
+            if (!PickSegment(bhk_world, actor, RE::NiPoint3(from.x, from.y, from.z), RE::NiPoint3(to.x, to.y, to.z), hit_pos))
+                return false;
+            hit = {hit_pos.x, hit_pos.y, hit_pos.z};
+            return true;
+        }
+
+        void Marker(int &index, const LedgeProbes::Vec3 &hit)
+        {
+            PlaceRayMarker<F>(state, index, RE::NiPoint3(hit.x, hit.y, hit.z));
+        }
+    };
+
+    template <std::uint32_t F>
+    bool ProbeKernel(RE::bhkWorld *bhk_world, RE::Actor *actor, RE::TESWorldSpace *worldspace, Globals::ActorState &state,
+                     const LedgeProbes::Params &params, const LedgeProbes::Input &input)
+    {
+        ProbeContext<F> context{bhk_world, actor, worldspace, state};
+        LedgeProbes::Output output{state.best_yaw, state.ledge_lip_distance};
+        bool ledge_detected;
+        if constexpr ((F & kReducedRing) != 0)
+            ledge_detected = LedgeProbes::ProbeRing(context, params, input, output, true);
+        else if constexpr ((F & kSweepProbe) != 0)
+            ledge_detected = LedgeProbes::ProbeSweep(context, params, input, output);
+        else if constexpr ((F & kAdaptiveRays) != 0)
+            ledge_detected = LedgeProbes::ProbeAdaptive(context, params, input, output);
+        else
+            ledge_detected = LedgeProbes::ProbeRing(context, params, input, output);
+        state.best_yaw = output.best_yaw;
+        state.ledge_lip_distance = output.ledge_lip_distance;
+        return ledge_detected;
+    }
+
+    using ProbeKernelFn = bool (*)(RE::bhkWorld *, RE::Actor *, RE::TESWorldSpace *, Globals::ActorState &, const LedgeProbes::Params &,
+                                   const LedgeProbes::Input &);
+
+    template <std::size_t... Masks>
+    constexpr std::array<ProbeKernelFn, sizeof...(Masks)> MakeProbeKernels(std::index_sequence<Masks...>)
+    {
+        return {&ProbeKernel<static_cast<std::uint32_t>(Masks)>...};
+    }
+
+    // One kernel per feature combination, indexed by the mask
+    constexpr auto g_probe_kernels = MakeProbeKernels(std::make_index_sequence<kProbeFeatureCount>{});
+    // Swapped by the watchdog while async probes may be running
+    std::atomic<ProbeKernelFn> g_probe_kernel = g_probe_kernels[0];
+    std::atomic<ProbeKernelFn> g_reduced_kernel = g_probe_kernels[kReducedRing];
+    std::atomic<std::uint32_t> g_probe_features = 0;
+
+    void SelectProbeKernel()
+    {
+        std::uint32_t features = 0;
+        if (Globals::show_markers)
+            features |= kShowMarkers;
+        if (Globals::two_phase_rays)
+            features |= kTwoPhaseRays;
+        if (Globals::terrain_fast_path)
+            features |= kTerrainFastPath;
+        // Far actors and the watchdog's fewer rays level use the reduced ring instead of the chosen kernel
+        const std::uint32_t reduced = features | kReducedRing;
+        if (Watchdog::CurrentLevel() >= Watchdog::kFewerRays)
+            features = reduced;
+        else if (Globals::sweep_probe)
+            features |= kSweepProbe;
+        else if (Globals::adaptive_rays)
+            features |= kAdaptiveRays;
+        g_probe_kernel.store(g_probe_kernels[features], std::memory_order_relaxed);
+        g_probe_features.store(features, std::memory_order_relaxed);
+        g_reduced_kernel.store(g_probe_kernels[reduced], std::memory_order_relaxed);
+        logger::debug("Selected ledge probe kernel {:#x}"sv, features);
+    }
+
+    std::uint32_t ReplayKernel()
+    {
+        const std::uint32_t features = g_probe_features.load(std::memory_order_relaxed);
+        std::uint32_t kernel = ReplayLog::kRingKernel;
+        if (features & kReducedRing)
+            kernel = ReplayLog::kReducedKernel;
+        else if (features & kSweepProbe)
+            kernel = ReplayLog::kSweepKernel;
+        else if (features & kAdaptiveRays)
+            kernel = ReplayLog::kAdaptiveKernel;
+        if (features & kTwoPhaseRays)
+            kernel |= ReplayLog::kTwoPhaseKernel;
+        return kernel;
+    }
+
+    // Builds whatever the cell's checks look up, on the main thread before any check runs.
+    void PrepareCell(RE::TESObjectCELL *cell)
+    {
+        if (!cell)
+            return;
+        // Cells in the baked ledge map need no runtime index
+        const bool baked_cell = Globals::baked_ledge_map && BakedLedges::HasCell(cell);
+        if (Globals::terrain_fast_path)
+            Terrain::EnsureGrid(cell);
+        if (Globals::ledge_index && !baked_cell)
+            LedgeIndex::EnsureIndex(cell);
+        if (Globals::ledge_distance_field && !baked_cell)
+            DistanceField::EnsureField(cell);
+    }
+
+    bool BeginCheck(RE::Actor *actor, Globals::ActorState &state, ProbeRequest &request)
     {
+        request.config = Config::Acquire();
+        const auto &config = *request.config;
         Globals::ActorState *state_check = Globals::CheckState(actor);
         if (!state_check)
         {
@@ -123,7 +365,7 @@ namespace Utils
             return false;
         }
         auto char_controller = actor->GetCharController();
-        if (char_controller && Globals::disable_on_stairs && char_controller->flags.any(RE::CHARACTER_FLAGS::kOnStairs))
+        if (char_controller && config.disable_on_stairs && char_controller->flags.any(RE::CHARACTER_FLAGS::kOnStairs))
         {
             logger::trace("Character on stairs and stairs disables ledge check."sv);
             return false;
@@ -143,150 +385,125 @@ namespace Utils
             return false;
         }
 
-        const auto havok_world_scale = RE::bhkWorld::GetWorldScale();
-        const float ray_length = 600.0f; // 600.0f
+        const bool baked_cell = Globals::baked_ledge_map && BakedLedges::HasCell(cell);
+
+        // Compared by value, a new controller, world or collision group all show up in the filter info
+        RE::CFilter filter_info;
+        actor->GetCollisionFilterInfo(filter_info);
+        if (state.pick_filter_info != filter_info.filter)
+        {
+            state.pick_filter = filter_info;
+            state.pick_filter.SetCollisionLayer(RE::COL_LAYER::kLineOfSight);
+            state.pick_filter_info = filter_info.filter;
+        }
 
-        const float direction_threshold = 0.7f; // Adjust for tighter/looser direction matching
         RE::NiPoint3 actor_pos = actor->GetPosition();
         RE::NiPoint3 current_linear_velocity;
         actor->GetLinearVelocity(current_linear_velocity);
         current_linear_velocity.z = 0.0f; // z is not important
         float velocity_length = current_linear_velocity.Length();
 
-        RE::NiPoint3 move_direction = {0.0f, 0.0f, 0.0f};
-        if (velocity_length > 0.0f)
-        {
-            move_direction = current_linear_velocity / velocity_length;
-        }
-        // Yaw offsets to use for rays around the actor
-        float actor_yaw = actor->GetAngleZ();
-        std::vector<float> yaw_offsets;
-        float angle_step = static_cast<float>(2.0 * RE::NI_PI / static_cast<long double>(Globals::num_rays));
-        for (int i = 0; i < Globals::num_rays; ++i)
-        {
-            yaw_offsets.push_back(actor_yaw + i * angle_step);
-        };
-        int i = 0; // increment into ray markers
-        bool ledge_detected = false;
-        std::vector<float> valid_yaws;
-        float dist_from_player = Globals::ledge_distance;
-        bool al_flag1;
-        bool al_flag2;
-        bool opposite_dir;
-        std::vector<float> hit_z;
-        std::vector<float> op_hit_z;
-        for (const float yaw : yaw_offsets)
-        {
-            dist_from_player = Globals::ledge_distance;
-            opposite_dir = false;
-            RE::NiPoint3 dir_vec(std::sin(yaw), std::cos(yaw), 0.0f);
-            float dir_length = dir_vec.Length();
-            if (dir_length == 0.0f)
-            {
-                continue;
-            }
-            RE::NiPoint3 normalized_dir = dir_vec / dir_length;
+        // Navmesh edges sit a little short of the actual drop, rays only confirm near one of them.
+        const float ledge_reach = config.ledge_reach;
+        // The watchdog's last level and far actors only trust cached ledges, cells without any are not probed
+        const bool far_actor = Globals::distance_lod && state.lod_tier >= ActorLod::kFar;
+        bool near_ledge = Watchdog::CurrentLevel() < Watchdog::kCachedOnly && !far_actor;
+        if (baked_cell)
+            near_ledge = BakedLedges::DistanceToNearestLedge(cell, actor_pos, ledge_reach) < ledge_reach;
+        else if (Globals::ledge_distance_field && DistanceField::HasField(cell))
+            near_ledge = DistanceField::DistanceToNearestLedge(cell, actor_pos, ledge_reach) < ledge_reach;
+        else if (Globals::ledge_index && LedgeIndex::HasIndex(cell))
+            near_ledge = LedgeIndex::DistanceToNearestLedge(cell, actor_pos, ledge_reach) < ledge_reach;
 
-            // Skip if we're moving and this direction doesn't match our movement
-            if (velocity_length > 0.0f)
-            {
-                float alignment = normalized_dir.Dot(move_direction);
-                float op_alignment = -(normalized_dir).Dot(move_direction);
-                al_flag1 = false;
-                al_flag2 = false;
-                if (alignment < direction_threshold)
-                    al_flag1 = true;
-                if (op_alignment < direction_threshold)
-                    al_flag2 = true;
-                else
-                {
-                    dist_from_player = 100.0f;
-                    opposite_dir = true;
-                }
+        request.actor = RE::NiPointer<RE::Actor>(actor);
+        request.bhk_world = RE::NiPointer<RE::bhkWorld>(bhk_world);
+        request.worldspace = cell->IsExteriorCell() ? cell->GetRuntimeData().worldSpace : nullptr;
+        request.actor_pos = actor_pos;
+        // Every probe direction is picked relative to movement, a still actor has nothing to probe.
+        request.needs_probe = velocity_length > 0.0f && near_ledge;
+        request.move_direction = request.needs_probe ? current_linear_velocity / velocity_length : RE::NiPoint3();
+        request.actor_yaw = actor->GetAngleZ();
+        request.pick_filter = state.pick_filter;
+        request.reduced_rays = Globals::distance_lod && state.lod_tier >= ActorLod::kMid;
+        request.in_midair = actor->IsInMidair();
+        request.best_yaw = state.best_yaw;
+        request.ledge_lip_distance = state.ledge_lip_distance;
+        request.ray_markers = state.ray_markers;
+        request.issued = std::chrono::steady_clock::now();
+        return true;
+    }
 
-                if (al_flag1 && al_flag2)
-                    continue;
-            }
-            else
-            {
-                continue;
-            }
+    void RunProbe(const ProbeRequest &request, ProbeResult &result)
+    {
+        Globals::ActorState scratch;
+        scratch.best_yaw = request.best_yaw;
+        scratch.ledge_lip_distance = request.ledge_lip_distance;
+        scratch.ray_markers = request.ray_markers;
 
-            RE::NiPoint3 ray_from = actor_pos + (normalized_dir * dist_from_player) + RE::NiPoint3(0, 0, 80);
-            RE::NiPoint3 ray_to = ray_from + RE::NiPoint3(0, 0, -ray_length);
+        auto *outer_commands = g_commands;
+        g_commands = &result.commands;
+        g_pick_filter = &request.pick_filter;
+        if (Globals::record_replay)
+            g_probe_log = &result.probes;
+        result.ledge_detected = false;
+        if (request.needs_probe)
+        {
+            auto *actor = request.actor.get();
+            auto *bhk_world = request.bhk_world.get();
+            const auto &kernel = request.reduced_rays ? g_reduced_kernel : g_probe_kernel;
+            const LedgeProbes::Input input{{request.actor_pos.x, request.actor_pos.y, request.actor_pos.z},
+                                           {request.move_direction.x, request.move_direction.y, request.move_direction.z},
+                                           request.actor_yaw};
+            result.ledge_detected = kernel.load(std::memory_order_relaxed)(bhk_world, actor, request.worldspace, scratch, request.config->probes, input);
+        }
+        g_commands = outer_commands;
+        g_pick_filter = nullptr;
+        g_probe_log = nullptr;
+        result.best_yaw = scratch.best_yaw;
+        result.ledge_lip_distance = scratch.ledge_lip_distance;
+    }
 
-            RE::bhkPickData ray;
-            ray.rayInput.from = ray_from * havok_world_scale;
-            ray.rayInput.to = ray_to * havok_world_scale;
-            RE::CFilter cFilter;
-            actor->GetCollisionFilterInfo(cFilter);
-            cFilter.SetCollisionLayer(RE::COL_LAYER::kLineOfSight);
-            ray.rayInput.filterInfo = cFilter;
+    bool FinishCheck(Globals::ActorState &state, const ProbeRequest &request, const ProbeResult &result)
+    {
+        state.best_yaw = result.best_yaw;
+        state.ledge_lip_distance = result.ledge_lip_distance;
+        for (const auto &command : result.commands)
+        {
+            if (g_commands)
+                g_commands->push_back(command);
+            else
+                ApplyCommand(command);
+        }
 
-            if (bhk_world->PickObject(ray) && ray.rayOutput.HasHit())
-            {
-                auto hitOwner = ray.rayOutput.rootCollidable->GetOwner<RE::hkpRigidBody>();
-                RE::NiPoint3 delta = ray_to - ray_from;
-                RE::NiPoint3 hit_pos = ray_from + delta * ray.rayOutput.hitFraction;
-                if (hitOwner)
-                {
-                    auto *user_data = hitOwner->GetUserData();
-                    auto *hit_ref = user_data ? user_data->As<RE::TESObjectREFR>() : nullptr;
-                    auto *hit_object = hit_ref ? hit_ref->GetBaseObject() : nullptr;
-
-                    if (hit_object && (hit_object->Is(RE::FormType::Flora) || hit_object->Is(RE::FormType::Tree)))
-                    {
-                        auto hit_ref_pos = hit_ref->GetPosition();
-                        if (hit_ref_pos.z < hit_pos.z)
-                            hit_pos = hit_ref_pos;
-                    }
-                }
+        const bool ledge_detected = result.ledge_detected;
+        if (result.ledge_lip_distance > 0.0f)
+            logger::trace("{} ledge lip {:.2f} units ahead"sv, request.actor->GetName(), result.ledge_lip_distance);
+        if (Globals::record_replay)
+            Recorder::AddCheck(request.actor->GetFormID(), request, result);
+        // The animation sinks reset these, a worker leaves them to the main thread
+        if (g_commands)
+            g_commands->push_back({Command::Type::kRecordDecision, nullptr, &state, nullptr, request.actor_pos, ledge_detected, !request.in_midair, request.config});
+        else
+            Tracking::RecordDecision(state, request.config->memory_duration, ledge_detected, !request.in_midair, request.actor_pos);
+        return ledge_detected;
+    }
 
-                if (Globals::show_markers) // if in debug mode move objects to ray hit positions
-                {
-                    if (auto marker = state.ray_markers[i]; marker)
-                        marker->SetPosition(hit_pos.x, hit_pos.y, hit_pos.z + 20);
-                    ++i;
-                }
-                if (opposite_dir)
-                    op_hit_z.push_back(hit_pos.z);
-                else
-                    hit_z.push_back(hit_pos.z);
-                if (actor_pos.z - hit_pos.z > Globals::drop_threshold)
-                {
-                    valid_yaws.push_back(yaw);
-                }
-            }
-            else
+    // Stops the actor at a found ledge.
+    void ApplyLedgeDecision(RE::Actor *actor, Globals::ActorState &state, const ProbeRequest &request, bool ledge_detected)
+    {
+        // A found ledge always marks the actor as on one, even before a worker's decision is recorded
+        if (ledge_detected)
+        {
+            // logger::trace("Stopping actor velocity."sv);
+            // Teleport actor to last safe point on ledge, helps with very fast animations like lunges.
+            if (request.config->teleport)
             {
-                if (opposite_dir)
-                    op_hit_z.push_back(actor_pos.z - Globals::drop_threshold - 10);
+                if (g_commands)
+                    g_commands->push_back({Command::Type::kMoveToSafePoint, actor, &state, nullptr, {}, false, false, request.config});
                 else
-                    hit_z.push_back(actor_pos.z - Globals::drop_threshold - 10);
+                    MoveActorToSafePoint(actor, state, *request.config);
             }
         }
-        if (!valid_yaws.empty())
-        {
-            float yaw = MathUtils::AverageAngles(valid_yaws);
-            state.best_yaw = MathUtils::NormalizeAngle(yaw);
-        }
-        if (op_hit_z.empty())
-            op_hit_z.push_back(actor_pos.z);
-        if (!hit_z.empty())
-        {
-            ledge_detected = MathUtils::IsMaxMinZPastDropThreshold(hit_z, op_hit_z, actor->GetPositionZ());
-        }
-        ++state.loops;
-        if (ledge_detected || state.loops > Globals::memory_duration)
-        {
-            state.is_on_ledge = ledge_detected;
-            state.loops = 0;
-        }
-        if (!ledge_detected && !actor->IsInMidair())
-        {
-            state.safe_grounded_positions.push_back(actor_pos);
-        }
-        return ledge_detected;
     }
 
     void EdgeCheck(RE::Actor *actor, Globals::ActorState &state)
@@ -295,33 +512,105 @@ namespace Utils
         if (!stateCheck || !actor)
             return;
         // logger::trace("Checking for ledge."sv);
-        if (IsLedgeAhead(actor, state) && (state.is_attacking || state.is_on_ledge))
+        ProbeRequest request;
+        if (!BeginCheck(actor, state, request))
+            return;
+        ProbeResult result;
+        RunProbe(request, result);
+        ApplyLedgeDecision(actor, state, request, FinishCheck(state, request, result));
+    }
+
+    // Applies the actor's probe from an earlier tick, or runs the check inline when there is no result
+    // newer than the max staleness, never both. Then queues the next probe.
+    void CheckAsync(RE::Actor *actor, Globals::ActorState &state)
+    {
+        const auto actor_id = actor->GetFormID();
+        ProbeRequest request;
+        ProbeResult result;
+        const bool taken = AsyncProbes::TakeResult(actor_id, request, result);
+        if (AsyncProbes::IsStale(actor_id))
         {
-            // logger::trace("Stopping actor velocity."sv);
-            // Teleport actor to last safe point on ledge, helps with very fast animations like lunges.
-            if (Globals::teleport)
-                MoveActorToSafePoint(actor, state);
+            logger::trace("No recent probe for {}, checking synchronously"sv, actor->GetName());
+            EdgeCheck(actor, state);
+            AsyncProbes::MarkFresh(actor_id);
         }
+        else if (taken)
+            ApplyLedgeDecision(actor, state, request, FinishCheck(state, request, result));
+
+        ProbeRequest next;
+        if (BeginCheck(actor, state, next))
+            AsyncProbes::Submit(actor_id, std::move(next));
     }
 
     void CheckAllActorsForLedges()
     {
+        const auto &config = Config::Current();
+        if (Globals::ledge_distance_field)
+            DistanceField::CollectFinished();
+        // NPCs sit out every other tick and then all ticks as the watchdog steps down
+        static bool npc_tick = false;
+        npc_tick = !npc_tick;
+        const auto level = Watchdog::CurrentLevel();
+        const bool check_npcs = level < Watchdog::kPlayerOnly && (level < Watchdog::kSlowerNPCs || npc_tick);
+        if (Globals::distance_lod)
+            ActorLod::BeginTick();
+        std::vector<std::pair<RE::Actor *, Globals::ActorState *>> checks;
         for (std::pair<const RE::FormID, Globals::ActorState &> actor_state : Globals::g_actor_states)
         {
             auto form_id = actor_state.first;
             auto actor_ptr = RE::TESForm::LookupByID<RE::Actor>(form_id);
             if (!actor_ptr)
                 continue;
-            auto &state = actor_state.second;
-            if (state.is_jumping && (Globals::jump_duration > static_cast<float>(clock() - state.jump_start) / CLOCKS_PER_SEC))
+            if (!check_npcs && !actor_ptr->IsPlayerRef())
                 continue;
-            else if (state.is_jumping)
-                state.is_jumping = false;
-
-            if (state.is_attacking || state.is_on_ledge)
+            auto &state = actor_state.second;
+            const float seconds_since_jump = static_cast<float>(clock() - state.jump_start) / CLOCKS_PER_SEC;
+            if (Tracking::WantsCheck(state, seconds_since_jump, config.jump_duration) && (!Globals::distance_lod || ActorLod::IsDue(actor_ptr, state)))
             {
-                EdgeCheck(actor_ptr, state);
+                PrepareCell(actor_ptr->GetParentCell());
+                checks.emplace_back(actor_ptr, &state);
             }
         }
+
+        if (Globals::async_checks)
+        {
+            for (auto &[actor, state] : checks)
+                CheckAsync(actor, *state);
+            return;
+        }
+
+        if (!Globals::parallel_checks || checks.size() < 2)
+        {
+            for (auto &[actor, state] : checks)
+                EdgeCheck(actor, *state);
+            return;
+        }
+
+        // Each check only touches its own actor state, the physics world is held for reading so
+        // it can't step while rays are in flight
+        std::vector<RE::bhkWorld *> worlds;
+        for (auto &[actor, state] : checks)
+        {
+            auto *cell = actor->GetParentCell();
+            auto *bhk_world = cell ? cell->GetbhkWorld() : nullptr;
+            if (bhk_world && std::ranges::find(worlds, bhk_world) == worlds.end())
+                worlds.push_back(bhk_world);
+        }
+        for (auto *bhk_world : worlds)
+            bhk_world->worldLock.LockForRead();
+        std::vector<std::vector<Command>> commands(checks.size());
+        WorkerPool::ParallelFor(checks.size(), [&](std::size_t i) {
+            g_commands = &commands[i];
+            EdgeCheck(checks[i].first, *checks[i].second);
+            g_commands = nullptr;
+        });
+        for (auto *bhk_world : worlds)
+            bhk_world->worldLock.UnlockForRead();
+
+        for (const auto &actor_commands : commands)
+        {
+            for (const auto &command : actor_commands)
+                ApplyCommand(command);
+        }
     }
 }
\ No newline at end of file
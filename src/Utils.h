@@ -2,6 +2,55 @@
 
 namespace Utils
 {
+    // World change made by a check running off the main thread, applied on the main thread afterwards.
+    struct Command
+    {
+        enum class Type
+        {
+            kMoveMarker,
+            kMoveToSafePoint,
+            kRecordDecision // The actor state half of FinishCheck, pos is the checked position
+        };
+
+        Type type;
+        RE::Actor *actor = nullptr;
+        Globals::ActorState *state = nullptr;
+        RE::TESObjectREFR *marker = nullptr;
+        RE::NiPoint3 pos;
+        bool ledge_detected = false;
+        bool grounded = false;
+        std::shared_ptr<const Config::Snapshot> config = nullptr; // The check's tuning, for the actor state commands
+    };
+
+    // Everything a ledge probe reads from the actor, captured on the main thread.
+    struct ProbeRequest
+    {
+        std::shared_ptr<const Config::Snapshot> config; // Taken once, every step of the check uses it
+        RE::NiPointer<RE::Actor> actor;
+        RE::NiPointer<RE::bhkWorld> bhk_world;
+        RE::TESWorldSpace *worldspace = nullptr; // Of an exterior cell, for the terrain fast path
+        RE::NiPoint3 actor_pos;
+        RE::NiPoint3 move_direction;
+        float actor_yaw = 0.0f;
+        RE::CFilter pick_filter;
+        bool needs_probe = false; // False for a still actor or one away from every known ledge
+        bool reduced_rays = false; // Probed with the reduced ring, for a distant or off-screen actor
+        bool in_midair = false;
+        float best_yaw = 0.0f;
+        float ledge_lip_distance = 0.0f;
+        std::vector<RE::TESObjectREFR *> ray_markers;
+        std::chrono::steady_clock::time_point issued;
+    };
+
+    struct ProbeResult
+    {
+        bool ledge_detected = false;
+        float best_yaw = 0.0f;
+        float ledge_lip_distance = 0.0f;
+        std::vector<Command> commands; // Debug marker moves
+        std::vector<ReplayLog::Probe> probes; // Every pick, only while recording a replay
+    };
+
     void AddTogglePowerToPlayer();
 
     void RemoveSpellsFromPlayer();
@@ -10,7 +59,20 @@ namespace Utils
 
     void CleanupActors();
 
-    bool IsLedgeAhead(RE::Actor *actor, Globals::ActorState &state);
+    // Picks the probe kernel compiled for the current options, call whenever they change.
+    void SelectProbeKernel();
+
+    // The selected probe kernel as the replay log names it.
+    std::uint32_t ReplayKernel();
+
+    // Main thread half of a ledge check: preconditions and the request. False if the check can't run.
+    bool BeginCheck(RE::Actor *actor, Globals::ActorState &state, ProbeRequest &request);
+
+    // Casts the request's rays. Only reads the world, safe off the main thread under a world read lock.
+    void RunProbe(const ProbeRequest &request, ProbeResult &result);
+
+    // Applies a probe's result to the actor's state, returns whether a ledge was found.
+    bool FinishCheck(Globals::ActorState &state, const ProbeRequest &request, const ProbeResult &result);
 
     void EdgeCheck(RE::Actor *actor, Globals::ActorState &state);
 
@@ -0,0 +1,48 @@
+namespace Watchdog
+{
+    constexpr float average_weight = 0.05f; // Of the newest frame in the moving average, about 20 frames deep
+    constexpr int frames_before_down = 30;  // Lets a new level settle before judging it
+    constexpr int frames_before_up = 300;   // Stepping up only after a long calm avoids flapping
+
+    Level g_level = kFull;
+    std::chrono::steady_clock::duration g_frame_cost{};
+    float g_average_share = 0.0f;
+    int g_frames_at_level = 0;
+
+    Level CurrentLevel()
+    {
+        return g_level;
+    }
+
+    void AddCost(std::chrono::steady_clock::duration cost)
+    {
+        g_frame_cost += cost;
+    }
+
+    void SetLevel(Level level)
+    {
+        logger::info("Ledge check quality level {} -> {}, plugin at {:.2f}% of the frame"sv, static_cast<int>(g_level), static_cast<int>(level),
+                     g_average_share * 100.0f);
+        g_level = level;
+        g_frames_at_level = 0;
+        Utils::SelectProbeKernel();
+    }
+
+    void EndFrame(float frame_seconds)
+    {
+        const float cost_seconds = std::chrono::duration<float>(g_frame_cost).count();
+        g_frame_cost = {};
+        // Paused or loading frames say nothing about the check cost
+        if (frame_seconds <= 0.0f)
+            return;
+        g_average_share += (cost_seconds / frame_seconds - g_average_share) * average_weight;
+        ++g_frames_at_level;
+
+        const float budget = Config::Current().frame_budget / 100.0f;
+        if (g_average_share > budget && g_frames_at_level >= frames_before_down && g_level + 1 < kLevelCount)
+            SetLevel(static_cast<Level>(g_level + 1));
+        // Half the budget leaves room for the cost the level above adds back
+        else if (g_average_share < budget * 0.5f && g_frames_at_level >= frames_before_up && g_level > kFull)
+            SetLevel(static_cast<Level>(g_level - 1));
+    }
+}
\ No newline at end of file
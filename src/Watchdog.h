@@ -0,0 +1,25 @@
+#pragma once
+
+// Measures the plugin's share of each frame and trades ledge check quality for time when it runs
+// over the budget, giving it back once there is headroom again.
+namespace Watchdog
+{
+    // Each level keeps the degradations of the ones before it.
+    enum Level
+    {
+        kFull,
+        kFewerRays,   // The reduced ring, three rays ahead and one behind
+        kSlowerNPCs,  // NPCs are checked every other tick
+        kPlayerOnly,  // Only the player is checked
+        kCachedOnly,  // Rays are only cast near a ledge a cached lookup knows of
+        kLevelCount
+    };
+
+    Level CurrentLevel();
+
+    // Adds time the plugin spent on the game thread this frame.
+    void AddCost(std::chrono::steady_clock::duration cost);
+
+    // Closes the frame, steps the level down or up when the averaged share calls for it.
+    void EndFrame(float frame_seconds);
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+namespace WorkerPool
+{
+    // Tasks of one thread, the owner pops from the back and thieves steal from the front.
+    struct Worker
+    {
+        std::mutex lock;
+        std::deque<std::size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> g_workers; // [0] belongs to the thread calling ParallelFor
+    std::vector<std::jthread> g_threads;
+
+    std::mutex g_batch_lock;
+    std::condition_variable_any g_batch_signal;
+    std::uint64_t g_batch = 0;
+
+    const std::function<void(std::size_t)> *g_task = nullptr;
+    std::atomic<std::size_t> g_remaining = 0;
+
+    bool PopOrSteal(std::size_t self, std::size_t &index)
+    {
+        {
+            auto &own = *g_workers[self];
+            std::scoped_lock lock(own.lock);
+            if (!own.tasks.empty())
+            {
+                index = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (std::size_t offset = 1; offset < g_workers.size(); ++offset)
+        {
+            auto &victim = *g_workers[(self + offset) % g_workers.size()];
+            std::scoped_lock lock(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                index = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void RunTasks(std::size_t self)
+    {
+        std::size_t index;
+        while (PopOrSteal(self, index))
+        {
+            (*g_task)(index);
+            g_remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    void WorkerLoop(std::stop_token stop_token, std::size_t self)
+    {
+        std::uint64_t seen_batch = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(g_batch_lock);
+                if (!g_batch_signal.wait(lock, stop_token, [&] { return g_batch != seen_batch; }))
+                    return;
+                seen_batch = g_batch;
+            }
+            RunTasks(self);
+        }
+    }
+
+    void Start(int thread_count)
+    {
+        if (!g_threads.empty())
+            return;
+        if (thread_count <= 0)
+            thread_count = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 2, 1, 7);
+        for (int i = 0; i <= thread_count; ++i)
+            g_workers.push_back(std::make_unique<Worker>());
+        for (int i = 1; i <= thread_count; ++i)
+            g_threads.emplace_back(WorkerLoop, static_cast<std::size_t>(i));
+        logger::info("Started {} ledge check worker threads"sv, thread_count);
+    }
+
+    void ParallelFor(std::size_t count, const std::function<void(std::size_t)> &task)
+    {
+        if (g_threads.empty() || count < 2)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                task(i);
+            return;
+        }
+
+        // The task is published before any index, a worker still draining the last batch may pick these up
+        g_task = &task;
+        g_remaining.store(count, std::memory_order_release);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto &worker = *g_workers[i % g_workers.size()];
+            std::scoped_lock lock(worker.lock);
+            worker.tasks.push_back(i);
+        }
+        {
+            std::scoped_lock lock(g_batch_lock);
+            ++g_batch;
+        }
+        g_batch_signal.notify_all();
+
+        RunTasks(0);
+        while (g_remaining.load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+    }
+}
\ No newline at end of file
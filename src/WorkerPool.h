@@ -0,0 +1,12 @@
+#pragma once
+
+// Small work-stealing pool for per-actor work. The calling thread takes part in every batch.
+namespace WorkerPool
+{
+    // Starts thread_count workers, 0 picks one per spare core (at most 7).
+    void Start(int thread_count);
+
+    // Runs task(i) for every i below count spread over the pool, returns once all of them are done.
+    // Runs everything on the calling thread if the pool isn't started.
+    void ParallelFor(std::size_t count, const std::function<void(std::size_t)> &task);
+}
\ No newline at end of file
@@ -5,13 +5,16 @@ namespace
         logger::info("Creating Event Sink(s)"sv);
         try
         {
-            Globals::g_actor_states.clear();
+            Globals::UntrackAll();
             const auto player = RE::PlayerCharacter::GetSingleton();
-            player->RemoveAnimationGraphEventSink(Events::AttackAnimationGraphEventSink::GetSingleton());
-            logger::info("Creating Player Event Sink"sv);
-            player->AddAnimationGraphEventSink(Events::AttackAnimationGraphEventSink::GetSingleton());
+            if (!Globals::global_animation_hook)
+            {
+                player->RemoveAnimationGraphEventSink(Events::AttackAnimationGraphEventSink::GetSingleton());
+                logger::info("Creating Player Event Sink"sv);
+                player->AddAnimationGraphEventSink(Events::AttackAnimationGraphEventSink::GetSingleton());
+            }
 
-            auto &state = Globals::g_actor_states[player->GetFormID()];
+            auto &state = Globals::TrackActor(player->GetFormID());
 
             if (state.ray_markers.empty() && Globals::show_markers)
                 Objects::InitializeRayMarkers(player);
@@ -21,6 +24,19 @@ namespace
                 RE::ScriptEventSourceHolder::GetSingleton()->RemoveEventSink(Events::CombatEventSink::GetSingleton());
                 RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(Events::CombatEventSink::GetSingleton());
             }
+            if (Globals::terrain_fast_path || Globals::ledge_index)
+            {
+                logger::info("Creating Cell Load Event Sink"sv);
+                RE::ScriptEventSourceHolder::GetSingleton()->RemoveEventSink(Events::CellLoadEventSink::GetSingleton());
+                RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(Events::CellLoadEventSink::GetSingleton());
+            }
+            if (Globals::rigid_body_cache)
+            {
+                logger::info("Creating Cell Detach Event Sink"sv);
+                RE::ScriptEventSourceHolder::GetSingleton()->RemoveEventSink(BodyCache::DetachEventSink::GetSingleton());
+                RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(BodyCache::DetachEventSink::GetSingleton());
+                BodyCache::Invalidate();
+            }
             if (Globals::use_spell_toggle)
                 Utils::AddTogglePowerToPlayer();
             else
@@ -56,6 +72,14 @@ namespace
         logger::info("Animation Ledge Block NG Plugin Starting"sv);
         Config::LoadConfig();
         Config::SetLogLevel();
+        if (Globals::watch_config)
+            Config::WatchFile();
+        if (Globals::record_replay)
+            Recorder::Start();
+        if (Globals::baked_ledge_map)
+            BakedLedges::Load();
+        if (Globals::parallel_checks)
+            WorkerPool::Start(Globals::worker_threads);
 
         SKSE::GetMessagingInterface()->RegisterListener("SKSE", MessageHandler);
         if (Hook::Install())
@@ -7,13 +7,42 @@
 #include "SimpleIni.h"
 #include <spdlog/sinks/basic_file_sink.h>
 namespace logger = SKSE::log;
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <unordered_set>
 #include <vector>
+#include "LedgeProbes.h"
+#include "AnimationTags.h"
+#include "Tracking.h"
 #include "Globals.h"
 #include "Config.h"
 #include "Events.h"
-#include "MathUtils.h"
 #include "Objects.h"
+#include "Terrain.h"
+#include "LedgeIndex.h"
+#include "LedgeMap.h"
+#include "ReplayLog.h"
+#include "BakedLedges.h"
+#include "LedgeCache.h"
+#include "DistanceField.h"
+#include "WorkerPool.h"
+#include "Watchdog.h"
+#include "ActorLod.h"
+#include "BodyCache.h"
 #include "Utils.h"
+#include "AsyncProbes.h"
+#include "Recorder.h"
 #include "Hook.h"
 
 #define DLLEXPORT __declspec(dllexport)
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal assertions for the portable unit tests: failures are printed and counted, main
+// returns the count so the test runner sees a non-zero exit code.
+namespace Check
+{
+    inline int failures = 0;
+
+    inline void Fail(const char *file, int line, const char *expression)
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        ++failures;
+    }
+}
+
+#define CHECK(expression) ((expression) ? (void)0 : Check::Fail(__FILE__, __LINE__, #expression))
+#define CHECK_NEAR(a, b, tolerance) CHECK((a) - (b) <= (tolerance) && (b) - (a) <= (tolerance))
\ No newline at end of file
@@ -0,0 +1,149 @@
+// Bakes a small fixture map, reads it back through a mapped file and checks the queries the
+// plugin makes, plus that damage anywhere in the file, header included, is rejected.
+
+#include "Check.h"
+#include "LedgeMap.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr float margin = 256.0f;
+    constexpr float spacing = 8.0f;
+
+    LedgeMap::BakedCell MakeCell(std::string_view editor_id, std::int32_t cell_x, std::int32_t cell_y, std::vector<LedgeMap::Edge> edges)
+    {
+        LedgeMap::BakedCell cell;
+        cell.space_hash = LedgeMap::HashEditorID(editor_id);
+        cell.cell_x = cell_x;
+        cell.cell_y = cell_y;
+        cell.field = LedgeMap::BuildDistanceField(edges, margin, spacing, 1024);
+        cell.edges = std::move(edges);
+        return cell;
+    }
+
+    std::vector<std::byte> BakeFixture()
+    {
+        std::vector<LedgeMap::BakedCell> cells;
+        // Listed out of order on purpose, Serialize sorts them for FindCell
+        cells.push_back(MakeCell("TestInterior", 0, 0, {{0.0f, 0.0f, 0.0f, 0.0f, 512.0f, 0.0f}, {0.0f, 512.0f, 0.0f, 512.0f, 512.0f, 0.0f}}));
+        cells.push_back(MakeCell("Tamriel", 1, 0, {}));
+        cells.push_back(MakeCell("Tamriel", 0, 0, {{1000.0f, 1000.0f, 64.0f, 2000.0f, 1000.0f, 64.0f}}));
+        return LedgeMap::Serialize(std::move(cells));
+    }
+
+    bool Opens(std::vector<std::byte> bytes, std::string &error)
+    {
+        LedgeMap::View view;
+        return view.Open(bytes, error);
+    }
+
+    void CheckQueries(const LedgeMap::View &view)
+    {
+        CHECK(view.Cells().size() == 3);
+
+        const auto tamriel = LedgeMap::HashEditorID("TAMRIEL");
+        CHECK(tamriel == LedgeMap::HashEditorID("Tamriel"));
+        CHECK(view.FindCell(tamriel, 5, 5) == nullptr);
+        CHECK(view.FindCell(LedgeMap::HashEditorID("Skyrim"), 0, 0) == nullptr);
+
+        const auto *cell = view.FindCell(tamriel, 0, 0);
+        CHECK(cell != nullptr);
+        if (cell)
+        {
+            const auto edges = view.GetEdges(*cell);
+            CHECK(edges.size() == 1);
+            if (!edges.empty())
+            {
+                CHECK(edges[0].x0 == 1000.0f && edges[0].x1 == 2000.0f);
+                CHECK(edges[0].z0 == 64.0f);
+            }
+            const auto field = view.GetField(*cell);
+            CHECK(field.distances != nullptr);
+            CHECK_NEAR(LedgeMap::SampleDistance(field, 1500.0f, 1000.0f, 1000.0f), 0.0f, spacing);
+            CHECK_NEAR(LedgeMap::SampleDistance(field, 1500.0f, 1100.0f, 1000.0f), 100.0f, spacing);
+            CHECK_NEAR(LedgeMap::SampleDistance(field, 900.0f, 1000.0f, 1000.0f), 100.0f, spacing);
+            CHECK(LedgeMap::SampleDistance(field, 1500.0f, 1200.0f, 50.0f) == 50.0f);
+            // Past the margin the distance is only known to be at least the margin
+            CHECK(LedgeMap::SampleDistance(field, 5000.0f, 5000.0f, 1000.0f) == margin);
+        }
+
+        // Baked without ledges: a record, but nothing anywhere near
+        const auto *empty = view.FindCell(tamriel, 1, 0);
+        CHECK(empty != nullptr);
+        if (empty)
+        {
+            CHECK(view.GetEdges(*empty).empty());
+            CHECK(LedgeMap::SampleDistance(view.GetField(*empty), 4500.0f, 100.0f, 300.0f) == 300.0f);
+        }
+
+        const auto *interior = view.FindCell(LedgeMap::HashEditorID("testinterior"), 0, 0);
+        CHECK(interior != nullptr);
+        if (interior)
+        {
+            CHECK(view.GetEdges(*interior).size() == 2);
+            CHECK_NEAR(LedgeMap::SampleDistance(view.GetField(*interior), 100.0f, 256.0f, 1000.0f), 100.0f, spacing);
+        }
+    }
+
+    void CheckDamage(const std::vector<std::byte> &bytes)
+    {
+        std::string error;
+
+        auto truncated = bytes;
+        truncated.pop_back();
+        CHECK(!Opens(truncated, error));
+
+        auto table_damage = bytes;
+        table_damage[table_damage.size() - 2] ^= std::byte{0x01};
+        CHECK(!Opens(table_damage, error));
+        CHECK(error == "checksum mismatch");
+
+        // Shifting the distance table by one sample stays in bounds and aligned, only the
+        // checksum over the header notices
+        auto header_damage = bytes;
+        LedgeMap::Header header;
+        std::memcpy(&header, header_damage.data(), sizeof(header));
+        header.distances_offset += 4;
+        std::memcpy(header_damage.data(), &header, sizeof(header));
+        CHECK(!Opens(header_damage, error));
+        CHECK(error == "checksum mismatch");
+
+        auto version = bytes;
+        version[4] = std::byte{0x7F};
+        CHECK(!Opens(version, error));
+    }
+}
+
+int main()
+{
+    const auto bytes = BakeFixture();
+    const auto path = (std::filesystem::temp_directory_path() / "ledgemap_test.ledgemap").string();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        CHECK(out.good());
+    }
+
+    {
+        LedgeMap::MappedFile file;
+        CHECK(file.Open(path));
+        LedgeMap::View view;
+        std::string error;
+        CHECK(view.Open(file.Bytes(), error));
+        if (!error.empty())
+            std::fprintf(stderr, "open: %s\n", error.c_str());
+        CheckQueries(view);
+    }
+    std::filesystem::remove(path);
+
+    CheckDamage(bytes);
+
+    if (Check::failures == 0)
+        std::printf("ledgemap_test: ok\n");
+    return Check::failures;
+}
\ No newline at end of file
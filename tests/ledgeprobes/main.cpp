@@ -0,0 +1,173 @@
+// Scenes for the probe kernels. Thin gaps: flat ground crossed by a trench a few units wide, at
+// every heading. The sweep kernel's single pick can jump a trench the ring's vertical rays fall
+// into, so the two must still agree on every scene. Side drops: ground falling away at an angle to
+// the movement, which the ring's outer rays see before the one closest to the movement does. The
+// adaptive and sweep kernels must agree with the ring on both.
+
+#include "Check.h"
+#include "LedgeProbes.h"
+
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using LedgeProbes::Vec3;
+
+    constexpr float trench_depth = -480.0f;
+
+    // Ground at z 0, except a trench between near and far units along heading from the origin.
+    struct TrenchWorld
+    {
+        Vec3 heading;
+        float near = 0.0f;
+        float far = 0.0f;
+
+        float Along(const Vec3 &p) const { return p.x * heading.x + p.y * heading.y; }
+
+        float Height(float along) const { return along >= near && along < far ? trench_depth : 0.0f; }
+    };
+
+    struct TrenchContext
+    {
+        static constexpr bool two_phase_rays = false;
+
+        const TrenchWorld &world;
+
+        bool Cast(const Vec3 &from, float length, Vec3 &hit) const
+        {
+            const float ground = world.Height(world.Along(from));
+            if (ground > from.z || ground < from.z - length)
+                return false;
+            hit = {from.x, from.y, ground};
+            return true;
+        }
+
+        // Walks the flat stretches the segment crosses, like SyntheticWorld::Pick.
+        bool Pick(const Vec3 &from, const Vec3 &to, Vec3 &hit) const
+        {
+            const float start = world.Along(from);
+            const float delta = world.Along(to) - start;
+            float borders[4] = {0.0f, 1.0f, 1.0f, 1.0f};
+            int count = 1;
+            for (const float border : {world.near, world.far})
+            {
+                const float t = delta != 0.0f ? (border - start) / delta : -1.0f;
+                if (t > 0.0f && t < 1.0f)
+                    borders[count++] = t;
+            }
+            if (count == 3 && borders[1] > borders[2])
+                std::swap(borders[1], borders[2]);
+            borders[count] = 1.0f;
+            for (int i = 0; i < count; ++i)
+            {
+                const float entry = borders[i];
+                const float exit = borders[i + 1];
+                const float ground = world.Height(start + delta * (entry + exit) * 0.5f);
+                const float entry_z = from.z + (to.z - from.z) * entry;
+                const float exit_z = from.z + (to.z - from.z) * exit;
+                if (entry_z <= ground)
+                {
+                    hit = from + (to - from) * entry;
+                    hit.z = ground;
+                    return true;
+                }
+                if (exit_z <= ground)
+                {
+                    hit = from + (to - from) * (entry + (exit - entry) * (entry_z - ground) / (entry_z - exit_z));
+                    hit.z = ground;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void Marker(int &index, const Vec3 &) const { ++index; }
+    };
+
+    struct Scene
+    {
+        float near;
+        float width;
+        bool ledge; // What the ring should find
+    };
+
+    int disagreements = 0;
+
+    // Runs the kernels on world, the others must decide as the ring does. Returns the ring's decision.
+    bool CheckKernels(const TrenchWorld &world, float move_yaw, float actor_yaw)
+    {
+        LedgeProbes::Params params;
+        params.Derive();
+        TrenchContext context{world};
+        const LedgeProbes::Input input{{}, {std::sin(move_yaw), std::cos(move_yaw), 0.0f}, actor_yaw};
+        LedgeProbes::Output ring_output;
+        LedgeProbes::Output adaptive_output;
+        LedgeProbes::Output sweep_output;
+        const bool ring = LedgeProbes::ProbeRing(context, params, input, ring_output);
+        const bool adaptive = LedgeProbes::ProbeAdaptive(context, params, input, adaptive_output);
+        const bool sweep = LedgeProbes::ProbeSweep(context, params, input, sweep_output);
+        if (adaptive != ring || sweep != ring)
+        {
+            std::fprintf(stderr, "drop %.1f to %.1f along %.2f, moving %.2f, facing %.2f: ring %d, adaptive %d, sweep %d\n", world.near, world.far,
+                         std::atan2(world.heading.x, world.heading.y), move_yaw, actor_yaw, ring, adaptive, sweep);
+            ++disagreements;
+        }
+        return ring;
+    }
+}
+
+int main()
+{
+    const float ledge_distance = LedgeProbes::Params{}.ledge_distance;
+    std::vector<Scene> scenes;
+    // Trenches under the ring's centre ray, from a crack to a stride
+    for (const float width : {2.0f, 4.0f, 8.0f, 16.0f, 32.0f})
+        for (const float share : {0.1f, 0.5f, 0.9f})
+            scenes.push_back({ledge_distance - width * share, width, true});
+    // Trenches past the ring's reach, neither kernel may find them
+    for (const float near : {40.0f, 60.0f, 90.0f})
+        scenes.push_back({near, 8.0f, false});
+    scenes.push_back({ledge_distance * 2.0f, 32.0f, false});
+
+    for (const auto &scene : scenes)
+    {
+        for (int step = 0; step < 24; ++step)
+        {
+            const float yaw = static_cast<float>(step * LedgeProbes::pi / 12.0);
+            const TrenchWorld world{{std::sin(yaw), std::cos(yaw), 0.0f}, scene.near, scene.near + scene.width};
+            CHECK(CheckKernels(world, yaw, yaw) == scene.ledge);
+        }
+    }
+
+    // Side drops: the ground falls away past near along a heading up to 60 degrees off the movement,
+    // with the actor facing the movement or a half ring step off it
+    int side_scenes = 0;
+    int side_ledges = 0;
+    for (const float near : {8.0f, 14.0f, 18.0f, 22.0f, 30.0f})
+    {
+        for (const float edge_degrees : {-60.0f, -45.0f, -30.0f, -15.0f, 15.0f, 30.0f, 45.0f, 60.0f})
+        {
+            for (const float facing : {0.0f, LedgeProbes::ray_angle_step * 0.5f})
+            {
+                for (int step = 0; step < 24; ++step)
+                {
+                    const float yaw = static_cast<float>(step * LedgeProbes::pi / 12.0);
+                    const float edge_yaw = yaw + edge_degrees * static_cast<float>(LedgeProbes::pi / 180.0);
+                    const TrenchWorld world{{std::sin(edge_yaw), std::cos(edge_yaw), 0.0f}, near, 1000.0f};
+                    side_ledges += CheckKernels(world, yaw, yaw + facing);
+                    ++side_scenes;
+                }
+            }
+        }
+    }
+    // Both outcomes must occur, or the scenes don't tell the kernels apart
+    CHECK(side_ledges > 0 && side_ledges < side_scenes);
+    CHECK(disagreements == 0);
+
+    if (Check::failures == 0)
+        std::printf("ledgeprobes_test: ok, %zu trench scenes at 24 headings, %d side drops of %d scenes\n", scenes.size(), side_ledges, side_scenes);
+    return Check::failures;
+}
\ No newline at end of file
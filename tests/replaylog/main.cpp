@@ -0,0 +1,160 @@
+// Encodes ticks whose deltas cover the varint and zigzag edges, large jumps either way, negative
+// values and ids far apart, and checks they decode back to the same fixed point values. A record cut
+// short anywhere must be refused.
+
+#include "Check.h"
+#include "ReplayLog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+namespace
+{
+    // Within half a fixed point step, the most the encoding may round.
+    void CheckVec(const ReplayLog::Vec3 &actual, const ReplayLog::Vec3 &expected, float scale)
+    {
+        CHECK_NEAR(actual.x, expected.x, 0.5f / scale);
+        CHECK_NEAR(actual.y, expected.y, 0.5f / scale);
+        CHECK_NEAR(actual.z, expected.z, 0.5f / scale);
+    }
+
+    ReplayLog::ActorFrame MakeActor(std::uint32_t id, ReplayLog::Vec3 position, float yaw, std::uint8_t flags)
+    {
+        ReplayLog::ActorFrame actor;
+        actor.actor_id = id;
+        actor.position = position;
+        actor.velocity = {-position.y * 0.01f, position.x * 0.01f, -1.0f};
+        actor.yaw = yaw;
+        actor.animation_type = 0xFF;
+        actor.flags = flags;
+        return actor;
+    }
+
+    std::vector<ReplayLog::Tick> MakeTicks()
+    {
+        using namespace ReplayLog;
+        std::vector<Tick> ticks;
+
+        Tick first;
+        first.index = 0;
+        first.time_us = 0;
+        // Zigzag turns -1 into 1 and 0 stays 0
+        first.actors.push_back(MakeActor(0x14, {0.0f, -1.0f / position_scale, 0.0f}, 0.0f, kPlayer));
+        auto checked = MakeActor(0xFF000800, {-250000.0f, 250000.0f, -30000.0f}, -3.1f, kChecked | kProbed | kLedgeDetected);
+        checked.probe_position = {-250001.0f, 249999.5f, -29990.0f};
+        checked.move_direction = {-0.6f, 0.8f, 0.0f};
+        checked.probe_yaw = 3.1f;
+        checked.probes.push_back({{-250000.0f, 250000.0f, -29900.0f}, {-250000.0f, 250000.0f, -30500.0f}, 0.0f});
+        checked.probes.push_back({{-250030.0f, 250040.0f, -29900.0f}, {-250030.0f, 250040.0f, -30500.0f}, 1.0f});
+        checked.probes.push_back({{-250000.0f, 250000.0f, -29900.0f}, {-249950.0f, 250000.0f, -30500.0f}, 0.3333f});
+        first.actors.push_back(checked);
+        ticks.push_back(first);
+
+        // Deltas on both sides of every 7 bit boundary
+        Tick second;
+        second.index = 127;
+        second.time_us = 128;
+        second.actors.push_back(MakeActor(0x14, {63.0f / position_scale, 64.0f / position_scale, -65.0f / position_scale}, 8191.0f / yaw_scale, 0));
+        second.actors.push_back(MakeActor(0xFF000800, {250000.0f, -250000.0f, 30000.0f}, 3.1f, kChecked));
+        ticks.push_back(second);
+
+        // Long gaps, an actor dropped and one seen for the first time
+        Tick third;
+        third.index = 127 + (1ull << 40);
+        third.time_us = 128 + (1ull << 35);
+        third.actors.push_back(MakeActor(0xFFFFFFFF, {-8192.0f, 8191.99f, 0.0f}, -0.0001f, kAttacking | kJumping | kInMidair | kOnLedge));
+        third.actors.push_back(MakeActor(0x14, {-1.0f, -1.0f, -1.0f}, -8192.0f / yaw_scale, 0));
+        ticks.push_back(third);
+        return ticks;
+    }
+
+    void CheckTick(const ReplayLog::Tick &actual, const ReplayLog::Tick &expected)
+    {
+        using namespace ReplayLog;
+        CHECK(actual.index == expected.index);
+        CHECK(actual.time_us == expected.time_us);
+        CHECK(actual.actors.size() == expected.actors.size());
+        if (actual.actors.size() != expected.actors.size())
+            return;
+        // The encoder sorts actors by id
+        auto sorted = expected.actors;
+        std::ranges::sort(sorted, {}, &ActorFrame::actor_id);
+        for (std::size_t a = 0; a < sorted.size(); ++a)
+        {
+            const auto &got = actual.actors[a];
+            const auto &want = sorted[a];
+            CHECK(got.actor_id == want.actor_id);
+            CheckVec(got.position, want.position, position_scale);
+            CheckVec(got.velocity, want.velocity, position_scale);
+            CHECK_NEAR(got.yaw, want.yaw, 0.5f / yaw_scale);
+            CHECK(got.animation_type == want.animation_type);
+            CHECK(got.flags == want.flags);
+            if (want.flags & kProbed)
+            {
+                CheckVec(got.probe_position, want.probe_position, position_scale);
+                CheckVec(got.move_direction, want.move_direction, fraction_scale);
+                CHECK_NEAR(got.probe_yaw, want.probe_yaw, 0.5f / yaw_scale);
+            }
+            CHECK(got.probes.size() == want.probes.size());
+            for (std::size_t p = 0; p < std::min(got.probes.size(), want.probes.size()); ++p)
+            {
+                CheckVec(got.probes[p].from, want.probes[p].from, position_scale);
+                CheckVec(got.probes[p].to, want.probes[p].to, position_scale);
+                CHECK_NEAR(got.probes[p].hit_fraction, want.probes[p].hit_fraction, 0.5f / fraction_scale);
+            }
+        }
+    }
+}
+
+int main()
+{
+    ReplayLog::FileHeader header;
+    header.drop_threshold = 150.0f;
+    header.ledge_distance = 25.0f;
+    header.ground_leeway = 10.0f;
+    header.refine_steps = 3;
+    header.kernel = ReplayLog::kSweepKernel | ReplayLog::kTwoPhaseKernel;
+
+    const auto ticks = MakeTicks();
+    auto bytes = ReplayLog::EncodeHeader(header);
+    ReplayLog::Encoder encoder;
+    std::vector<std::size_t> record_ends;
+    for (const auto &tick : ticks)
+    {
+        encoder.Encode(tick, bytes);
+        record_ends.push_back(bytes.size());
+    }
+
+    ReplayLog::Decoder decoder;
+    CHECK(decoder.Open(bytes));
+    CHECK(decoder.Header().kernel == header.kernel);
+    CHECK(decoder.Header().refine_steps == header.refine_steps);
+    CHECK(decoder.Header().drop_threshold == header.drop_threshold);
+    ReplayLog::Tick tick;
+    for (const auto &expected : ticks)
+    {
+        CHECK(decoder.Next(tick));
+        CheckTick(tick, expected);
+    }
+    CHECK(!decoder.Next(tick));
+
+    // Cut inside the last record: the first two still decode, the torn one is refused
+    for (std::size_t cut = record_ends[1] + 1; cut < record_ends[2]; ++cut)
+    {
+        const std::span<const std::byte> torn(bytes.data(), cut);
+        ReplayLog::Decoder partial;
+        CHECK(partial.Open(torn));
+        CHECK(partial.Next(tick) && partial.Next(tick));
+        CHECK(!partial.Next(tick));
+    }
+
+    auto old_version = bytes;
+    old_version[4] = std::byte{2};
+    CHECK(!decoder.Open(old_version));
+
+    if (Check::failures == 0)
+        std::printf("replaylog_test: ok, %zu ticks in %zu bytes\n", ticks.size(), bytes.size());
+    return Check::failures;
+}
\ No newline at end of file
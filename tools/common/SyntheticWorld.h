@@ -0,0 +1,98 @@
+#pragma once
+
+#include "LedgeProbes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Deterministic terrain for the tools: square plateaus of cell_size units, each flat at a height
+// picked by hashing its grid position. Neighbouring plateaus differ by a step, a slope's worth or
+// a drop well past the default drop threshold, so actors walking it keep meeting ledges. Rays are
+// answered exactly, a slanted pick walks the plateaus it crosses.
+class SyntheticWorld
+{
+public:
+    static constexpr float cell_size = 256.0f;
+
+    explicit SyntheticWorld(std::uint32_t seed = 1) : seed(seed) {}
+
+    float Height(float x, float y) const { return CellHeight(Cell(x), Cell(y)); }
+
+    // Vertical ray down from from, like CastProbe.
+    bool Cast(const LedgeProbes::Vec3 &from, float length, LedgeProbes::Vec3 &hit) const
+    {
+        const float ground = Height(from.x, from.y);
+        if (ground > from.z || ground < from.z - length)
+            return false;
+        hit = {from.x, from.y, ground};
+        return true;
+    }
+
+    // Any segment, like PickSegment. Hits the first plateau whose top it passes below.
+    bool Pick(const LedgeProbes::Vec3 &from, const LedgeProbes::Vec3 &to, LedgeProbes::Vec3 &hit) const
+    {
+        const LedgeProbes::Vec3 delta = to - from;
+        long cx = Cell(from.x);
+        long cy = Cell(from.y);
+        const long step_x = delta.x > 0.0f ? 1 : -1;
+        const long step_y = delta.y > 0.0f ? 1 : -1;
+        // Segment parameter of the next plateau border crossed along x and along y
+        const float inf = std::numeric_limits<float>::infinity();
+        float next_x = delta.x != 0.0f ? ((cx + (step_x > 0 ? 1 : 0)) * cell_size - from.x) / delta.x : inf;
+        float next_y = delta.y != 0.0f ? ((cy + (step_y > 0 ? 1 : 0)) * cell_size - from.y) / delta.y : inf;
+        const float span_x = delta.x != 0.0f ? cell_size / std::abs(delta.x) : inf;
+        const float span_y = delta.y != 0.0f ? cell_size / std::abs(delta.y) : inf;
+        float t = 0.0f;
+        while (t <= 1.0f)
+        {
+            const float exit = std::min({next_x, next_y, 1.0f});
+            const float ground = CellHeight(cx, cy);
+            const float entry_z = from.z + delta.z * t;
+            const float exit_z = from.z + delta.z * exit;
+            if (entry_z <= ground)
+            {
+                // Entered through the plateau's side
+                hit = from + delta * t;
+                hit.z = ground;
+                return true;
+            }
+            if (exit_z <= ground)
+            {
+                hit = from + delta * (t + (exit - t) * (entry_z - ground) / (entry_z - exit_z));
+                hit.z = ground;
+                return true;
+            }
+            if (exit >= 1.0f)
+                break;
+            t = exit;
+            if (next_x < next_y)
+            {
+                cx += step_x;
+                next_x += span_x;
+            }
+            else
+            {
+                cy += step_y;
+                next_y += span_y;
+            }
+        }
+        return false;
+    }
+
+private:
+    static long Cell(float value) { return static_cast<long>(std::floor(value / cell_size)); }
+
+    float CellHeight(long x, long y) const
+    {
+        std::uint32_t hash = seed ^ (static_cast<std::uint32_t>(x) * 0x9E3779B1u) ^ (static_cast<std::uint32_t>(y) * 0x85EBCA77u);
+        hash ^= hash >> 15;
+        hash *= 0x2C1B3C6Du;
+        hash ^= hash >> 12;
+        constexpr float heights[8] = {0.0f, 0.0f, 0.0f, 24.0f, 48.0f, 96.0f, -240.0f, -480.0f};
+        return heights[hash & 7];
+    }
+
+    std::uint32_t seed;
+};
\ No newline at end of file
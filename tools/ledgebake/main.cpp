@@ -0,0 +1,433 @@
+// ledgebake: bakes exported navmesh and collision geometry into the plugin's ledge map.
+//
+//   ledgebake [options] -o <out.ledgemap> (--worldspace <EditorID> | --interior <EditorID>) <geometry.obj>...
+//   ledgebake --verify <file.ledgemap>
+//
+// Geometry is Wavefront OBJ in game units. Objects or groups named navmesh* are navmesh triangles,
+// everything else is collision. Worldspace geometry is split into 4096 unit exterior cells by
+// position, interiors are a single cell. Options:
+//   --drop-threshold <units>  Drop behind a navmesh boundary edge that makes it a ledge (150)
+//   --ledge-distance <units>  How far apart the drop is sampled along an edge, the plugin's LedgeDistance (25)
+//   --spacing <units>         Distance field sample spacing (8)
+//   --margin <units>          How far past the edges the distance field reaches (256)
+
+#include "LedgeMap.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct Vec3
+    {
+        float x, y, z;
+    };
+
+    struct Mesh
+    {
+        std::vector<Vec3> vertices;
+        std::vector<std::array<std::uint32_t, 3>> triangles;
+    };
+
+    struct Space
+    {
+        std::string editor_id;
+        bool interior = false;
+        std::vector<std::string> files;
+    };
+
+    struct Options
+    {
+        float drop_threshold = 150.0f;
+        float ledge_distance = 25.0f;
+        float spacing = 8.0f;
+        float margin = 256.0f;
+        int max_samples = 1024;
+        std::string output;
+        std::vector<Space> spaces;
+    };
+
+    constexpr float probe_offset = 24.0f; // Same as the plugin's runtime index
+    constexpr float ray_length = 600.0f;
+    constexpr float bucket_size = 256.0f;
+
+    // Adds a vertex, merging it with an existing one at the same position so navmesh
+    // triangles exported per cell still share edges.
+    std::uint32_t AddWelded(Mesh &mesh, std::map<std::tuple<long, long, long>, std::uint32_t> &welded, const Vec3 &v)
+    {
+        const auto key = std::make_tuple(std::lround(v.x * 8.0f), std::lround(v.y * 8.0f), std::lround(v.z * 8.0f));
+        const auto [it, inserted] = welded.try_emplace(key, static_cast<std::uint32_t>(mesh.vertices.size()));
+        if (inserted)
+            mesh.vertices.push_back(v);
+        return it->second;
+    }
+
+    bool LoadObj(const std::string &path, Mesh &navmesh, Mesh &collision)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::fprintf(stderr, "error: cannot open %s\n", path.c_str());
+            return false;
+        }
+        std::vector<Vec3> positions;
+        std::map<std::tuple<long, long, long>, std::uint32_t> navmesh_welded;
+        std::map<std::tuple<long, long, long>, std::uint32_t> collision_welded;
+        bool in_navmesh = false;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream tokens(line);
+            std::string kind;
+            tokens >> kind;
+            if (kind == "v")
+            {
+                Vec3 v{};
+                tokens >> v.x >> v.y >> v.z;
+                positions.push_back(v);
+            }
+            else if (kind == "o" || kind == "g")
+            {
+                std::string name;
+                tokens >> name;
+                std::ranges::transform(name, name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                in_navmesh = name.starts_with("navmesh");
+            }
+            else if (kind == "f")
+            {
+                Mesh &mesh = in_navmesh ? navmesh : collision;
+                auto &welded = in_navmesh ? navmesh_welded : collision_welded;
+                std::vector<std::uint32_t> face;
+                std::string corner;
+                while (tokens >> corner)
+                {
+                    long index = std::strtol(corner.c_str(), nullptr, 10); // "v/vt/vn" stops at the slash
+                    if (index < 0)
+                        index += static_cast<long>(positions.size()) + 1;
+                    if (index < 1 || index > static_cast<long>(positions.size()))
+                    {
+                        std::fprintf(stderr, "error: %s: bad face index in \"%s\"\n", path.c_str(), line.c_str());
+                        return false;
+                    }
+                    face.push_back(AddWelded(mesh, welded, positions[index - 1]));
+                }
+                for (std::size_t i = 2; i < face.size(); ++i)
+                    mesh.triangles.push_back({face[0], face[i - 1], face[i]});
+            }
+        }
+        return true;
+    }
+
+    // Triangles bucketed by their xy bounds, for vertical rays.
+    class GroundGrid
+    {
+    public:
+        explicit GroundGrid(const Mesh &mesh) : mesh(mesh)
+        {
+            if (mesh.triangles.empty())
+                return;
+            min_x = min_y = std::numeric_limits<float>::max();
+            float max_x = std::numeric_limits<float>::lowest();
+            float max_y = std::numeric_limits<float>::lowest();
+            for (const auto &v : mesh.vertices)
+            {
+                min_x = std::min(min_x, v.x);
+                min_y = std::min(min_y, v.y);
+                max_x = std::max(max_x, v.x);
+                max_y = std::max(max_y, v.y);
+            }
+            width = static_cast<int>((max_x - min_x) / bucket_size) + 1;
+            height = static_cast<int>((max_y - min_y) / bucket_size) + 1;
+            buckets.resize(static_cast<std::size_t>(width) * height);
+            for (std::uint32_t t = 0; t < mesh.triangles.size(); ++t)
+            {
+                const auto &a = mesh.vertices[mesh.triangles[t][0]];
+                const auto &b = mesh.vertices[mesh.triangles[t][1]];
+                const auto &c = mesh.vertices[mesh.triangles[t][2]];
+                const int x0 = Column(std::min({a.x, b.x, c.x}));
+                const int x1 = Column(std::max({a.x, b.x, c.x}));
+                const int y0 = Row(std::min({a.y, b.y, c.y}));
+                const int y1 = Row(std::max({a.y, b.y, c.y}));
+                for (int y = y0; y <= y1; ++y)
+                    for (int x = x0; x <= x1; ++x)
+                        buckets[static_cast<std::size_t>(y) * width + x].push_back(t);
+            }
+        }
+
+        // First surface hit by a ray going down from (x, y, from_z), false if none within length.
+        bool CastDown(float x, float y, float from_z, float length, float &hit_z) const
+        {
+            if (buckets.empty())
+                return false;
+            const int column = Column(x);
+            const int row = Row(y);
+            if (x < min_x || y < min_y || column >= width || row >= height)
+                return false;
+            bool hit = false;
+            for (const std::uint32_t t : buckets[static_cast<std::size_t>(row) * width + column])
+            {
+                const auto &a = mesh.vertices[mesh.triangles[t][0]];
+                const auto &b = mesh.vertices[mesh.triangles[t][1]];
+                const auto &c = mesh.vertices[mesh.triangles[t][2]];
+                // Barycentric coordinates of (x, y) in the triangle's xy projection
+                const float det = (b.y - c.y) * (a.x - c.x) + (c.x - b.x) * (a.y - c.y);
+                if (std::abs(det) < 1e-6f)
+                    continue; // Vertical wall, a vertical ray can't hit it
+                const float wa = ((b.y - c.y) * (x - c.x) + (c.x - b.x) * (y - c.y)) / det;
+                const float wb = ((c.y - a.y) * (x - c.x) + (a.x - c.x) * (y - c.y)) / det;
+                const float wc = 1.0f - wa - wb;
+                if (wa < 0.0f || wb < 0.0f || wc < 0.0f)
+                    continue;
+                const float z = wa * a.z + wb * b.z + wc * c.z;
+                if (z > from_z || z < from_z - length || (hit && z <= hit_z))
+                    continue;
+                hit_z = z;
+                hit = true;
+            }
+            return hit;
+        }
+
+    private:
+        int Column(float x) const { return std::clamp(static_cast<int>((x - min_x) / bucket_size), 0, width - 1); }
+        int Row(float y) const { return std::clamp(static_cast<int>((y - min_y) / bucket_size), 0, height - 1); }
+
+        const Mesh &mesh;
+        float min_x = 0.0f;
+        float min_y = 0.0f;
+        int width = 0;
+        int height = 0;
+        std::vector<std::vector<std::uint32_t>> buckets;
+    };
+
+    // Navmesh boundary edges with a drop (or nothing) behind them, the same test the plugin's
+    // runtime index does with Havok rays. Runs of dropping samples along an edge are separate edges.
+    std::vector<LedgeMap::Edge> FindLedgeEdges(const Mesh &navmesh, const GroundGrid &ground, float drop_threshold, float ledge_distance)
+    {
+        std::map<std::pair<std::uint32_t, std::uint32_t>, int> edge_use;
+        for (const auto &triangle : navmesh.triangles)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                const auto a = triangle[e];
+                const auto b = triangle[(e + 1) % 3];
+                ++edge_use[std::minmax(a, b)];
+            }
+        }
+
+        std::vector<LedgeMap::Edge> edges;
+        for (const auto &triangle : navmesh.triangles)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                if (edge_use[std::minmax(triangle[e], triangle[(e + 1) % 3])] != 1)
+                    continue;
+                const Vec3 &a = navmesh.vertices[triangle[e]];
+                const Vec3 &b = navmesh.vertices[triangle[(e + 1) % 3]];
+                const Vec3 &c = navmesh.vertices[triangle[(e + 2) % 3]];
+
+                // Outward normal, away from the triangle's third vertex
+                float nx = b.y - a.y;
+                float ny = a.x - b.x;
+                const float length = std::hypot(nx, ny);
+                if (length == 0.0f)
+                    continue;
+                nx /= length;
+                ny /= length;
+                if (nx * (c.x - a.x) + ny * (c.y - a.y) > 0.0f)
+                {
+                    nx = -nx;
+                    ny = -ny;
+                }
+
+                // Sampled every ledge_distance along the edge
+                const int samples = std::max(1, static_cast<int>(std::ceil(std::hypot(b.x - a.x, b.y - a.y, b.z - a.z) / ledge_distance)));
+                const auto point_at = [&](float t) {
+                    return Vec3{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t};
+                };
+                int run_start = -1;
+                for (int s = 0; s <= samples; ++s)
+                {
+                    bool drops = false;
+                    if (s < samples)
+                    {
+                        const Vec3 sample = point_at((s + 0.5f) / samples);
+                        float ground_z = 0.0f;
+                        drops = !ground.CastDown(sample.x + nx * probe_offset, sample.y + ny * probe_offset, sample.z + 80.0f, ray_length, ground_z) ||
+                                sample.z - ground_z > drop_threshold;
+                    }
+                    if (drops && run_start < 0)
+                        run_start = s;
+                    else if (!drops && run_start >= 0)
+                    {
+                        const Vec3 start = point_at(static_cast<float>(run_start) / samples);
+                        const Vec3 end = s == samples ? b : point_at(static_cast<float>(s) / samples);
+                        edges.push_back({start.x, start.y, start.z, end.x, end.y, end.z});
+                        run_start = -1;
+                    }
+                }
+            }
+        }
+        return edges;
+    }
+
+    bool BakeSpace(const Space &space, const Options &options, std::vector<LedgeMap::BakedCell> &cells)
+    {
+        Mesh navmesh;
+        Mesh collision;
+        for (const auto &file : space.files)
+        {
+            if (!LoadObj(file, navmesh, collision))
+                return false;
+        }
+        if (navmesh.triangles.empty())
+        {
+            std::fprintf(stderr, "error: %s has no navmesh triangles\n", space.editor_id.c_str());
+            return false;
+        }
+        // Without exported collision the navmesh itself is the best ground there is
+        const GroundGrid ground(collision.triangles.empty() ? navmesh : collision);
+        const auto edges = FindLedgeEdges(navmesh, ground, options.drop_threshold, options.ledge_distance);
+
+        const std::uint64_t space_hash = LedgeMap::HashEditorID(space.editor_id);
+        std::map<std::pair<std::int32_t, std::int32_t>, std::vector<LedgeMap::Edge>> cell_edges;
+        if (space.interior)
+            cell_edges[{0, 0}] = edges;
+        else
+        {
+            // Every cell with navmesh gets a record, even without ledges, so the plugin knows it was baked
+            for (const auto &v : navmesh.vertices)
+                cell_edges[{static_cast<std::int32_t>(std::floor(v.x / LedgeMap::cell_size)),
+                            static_cast<std::int32_t>(std::floor(v.y / LedgeMap::cell_size))}];
+            for (const auto &edge : edges)
+            {
+                const float mid_x = (edge.x0 + edge.x1) * 0.5f;
+                const float mid_y = (edge.y0 + edge.y1) * 0.5f;
+                cell_edges[{static_cast<std::int32_t>(std::floor(mid_x / LedgeMap::cell_size)),
+                            static_cast<std::int32_t>(std::floor(mid_y / LedgeMap::cell_size))}]
+                    .push_back(edge);
+            }
+        }
+
+        for (auto &[coordinates, edges_in_cell] : cell_edges)
+        {
+            LedgeMap::BakedCell cell;
+            cell.space_hash = space_hash;
+            cell.cell_x = coordinates.first;
+            cell.cell_y = coordinates.second;
+            cell.field = LedgeMap::BuildDistanceField(edges_in_cell, options.margin, options.spacing, options.max_samples);
+            cell.edges = std::move(edges_in_cell);
+            cells.push_back(std::move(cell));
+        }
+        std::printf("%s: %zu navmesh triangles, %zu ledge edges, %zu cells\n", space.editor_id.c_str(),
+                    navmesh.triangles.size(), edges.size(), cell_edges.size());
+        return true;
+    }
+
+    int Verify(const std::string &path)
+    {
+        LedgeMap::MappedFile file;
+        if (!file.Open(path))
+        {
+            std::fprintf(stderr, "error: cannot map %s\n", path.c_str());
+            return 1;
+        }
+        LedgeMap::View view;
+        std::string error;
+        if (!view.Open(file.Bytes(), error))
+        {
+            std::fprintf(stderr, "error: %s: %s\n", path.c_str(), error.c_str());
+            return 1;
+        }
+        std::size_t edge_count = 0;
+        std::size_t sample_count = 0;
+        for (const auto &cell : view.Cells())
+        {
+            edge_count += cell.edge_count;
+            sample_count += static_cast<std::size_t>(cell.field_width) * cell.field_height;
+        }
+        std::printf("%s: version %u, %zu cells, %zu ledge edges, %zu field samples, checksum ok\n", path.c_str(),
+                    LedgeMap::file_version, view.Cells().size(), edge_count, sample_count);
+        return 0;
+    }
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+                     "usage: ledgebake [--drop-threshold N] [--ledge-distance N] [--spacing N] [--margin N] -o <out.ledgemap>\n"
+                     "                 (--worldspace <EditorID> | --interior <EditorID>) <geometry.obj>...\n"
+                     "       ledgebake --verify <file.ledgemap>\n");
+    }
+
+    bool ParseFloat(const char *text, float &value)
+    {
+        char *end = nullptr;
+        value = std::strtof(text, &end);
+        return end && *end == '\0' && value > 0.0f;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--verify" && has_value)
+            return Verify(argv[++i]);
+        if (arg == "-o" && has_value)
+            options.output = argv[++i];
+        else if ((arg == "--worldspace" || arg == "--interior") && has_value)
+            options.spaces.push_back({argv[++i], arg == "--interior", {}});
+        else if (arg == "--drop-threshold" && has_value && ParseFloat(argv[++i], options.drop_threshold))
+            continue;
+        else if (arg == "--ledge-distance" && has_value && ParseFloat(argv[++i], options.ledge_distance))
+            continue;
+        else if (arg == "--spacing" && has_value && ParseFloat(argv[++i], options.spacing))
+            continue;
+        else if (arg == "--margin" && has_value && ParseFloat(argv[++i], options.margin))
+            continue;
+        else if (!arg.starts_with("-") && !options.spaces.empty())
+            options.spaces.back().files.push_back(arg);
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (options.output.empty() || options.spaces.empty())
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::vector<LedgeMap::BakedCell> cells;
+    for (const auto &space : options.spaces)
+    {
+        if (!BakeSpace(space, options, cells))
+            return 1;
+    }
+
+    const auto bytes = LedgeMap::Serialize(std::move(cells));
+    std::ofstream out(options.output, std::ios::binary);
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out)
+    {
+        std::fprintf(stderr, "error: cannot write %s\n", options.output.c_str());
+        return 1;
+    }
+    std::printf("wrote %s (%zu bytes)\n", options.output.c_str(), bytes.size());
+    return 0;
+}
@@ -0,0 +1,760 @@
+// ledgebench: times the ledge check pipeline's building blocks on a synthetic world.
+//
+//   ledgebench [--filter <text>] [--min-time <seconds>] [--repetitions <n>] [--json <out.json>]
+//              [--baseline <baseline.json>]
+//
+// Runs every benchmark whose name contains the filter text for at least min-time (0.2) seconds,
+// repetitions (5) times, and prints the fastest time, heap allocations and rays per operation.
+// --json writes the results, in the format --baseline reads, so a results file can be committed as
+// the next baseline. --baseline compares the results with a stored file, tools/ledgebench/baseline.json
+// is the committed one, and exits with 1 when a baseline benchmark the filter selects didn't run or
+// a deterministic metric got worse by more than its tolerance. Times are only advisory, a shared or
+// throttled machine swings them well past any useful tolerance, so a slower row is printed but
+// doesn't fail the run:
+//   time_tolerance     Slowdown before a row is printed as slower, as a fraction of the baseline time (0.5)
+//   alloc_tolerance    Allowed extra allocations per operation, as a fraction rounded up to whole
+//                      allocations (0.5). Standard libraries grow vectors differently, the ceiling
+//                      absorbs that, but a benchmark that didn't allocate must not start
+//   ray_tolerance      Allowed extra rays per operation, as a fraction (0)
+//   missed_tolerance   Allowed extra ring ledges missed, as a count (0)
+// Tolerances are read from the baseline's top level and can be overridden per benchmark. Times are
+// compared relative to reference/machine, plain arithmetic that runs every time, so a baseline
+// written on another machine reads about right.
+//
+// The probes are the plugin's own, answered from SyntheticWorld instead of Havok, so times show
+// the decision logic and ray counts, not pick costs. Groups:
+//   math/      AverageAngles, NormalizeAngle and IsMaxMinZPastDropThreshold
+//   pattern/   A probe kernel whose rays all hit flat ground at once, the cost of laying out the rays
+//   decision/  One tick of N actors deciding on the synthetic world, per kernel, at 1/10/100/1000 actors.
+//              Only the probe kernel: BeginCheck's gating of still actors, known ledges and LOD is
+//              left out, it only ever skips probes
+// After the table, every decision row's kernel is compared with the ring on the same actors: how
+// many of their decisions agree, so a faster row can be weighed against what it decides differently.
+// Each decision row also records missed_ledges, how many of the ledges the ring finds for 20000
+// actors its kernel doesn't, a metric of its own that the baseline gates like the others.
+
+#include "LedgeProbes.h"
+#include "SyntheticWorld.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    // Heap allocations since start, counted by the operator new below
+    std::uint64_t g_allocations = 0;
+}
+
+// GCC can't tell these are a matching pair once they are inlined into the standard containers
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+    struct Options
+    {
+        std::string filter;
+        double min_time = 0.2;
+        long repetitions = 5;
+        std::string json;
+        std::string baseline;
+    };
+
+    struct Counters
+    {
+        std::uint64_t rays = 0;
+    };
+
+    // Rays stop at flat ground 80 units down, no ray ever finds a drop
+    template <bool TwoPhase>
+    struct FlatContext
+    {
+        static constexpr bool two_phase_rays = TwoPhase;
+
+        Counters &counters;
+
+        bool Cast(const LedgeProbes::Vec3 &from, float, LedgeProbes::Vec3 &hit)
+        {
+            ++counters.rays;
+            hit = {from.x, from.y, from.z - 80.0f};
+            return true;
+        }
+
+        bool Pick(const LedgeProbes::Vec3 &from, const LedgeProbes::Vec3 &to, LedgeProbes::Vec3 &hit)
+        {
+            ++counters.rays;
+            hit = from + (to - from) * std::min(80.0f / (from.z - to.z), 1.0f);
+            hit.z = from.z - 80.0f;
+            return true;
+        }
+
+        void Marker(int &, const LedgeProbes::Vec3 &) {}
+    };
+
+    template <bool TwoPhase>
+    struct WorldContext
+    {
+        static constexpr bool two_phase_rays = TwoPhase;
+
+        const SyntheticWorld &world;
+        Counters &counters;
+
+        bool Cast(const LedgeProbes::Vec3 &from, float length, LedgeProbes::Vec3 &hit)
+        {
+            ++counters.rays;
+            return world.Cast(from, length, hit);
+        }
+
+        bool Pick(const LedgeProbes::Vec3 &from, const LedgeProbes::Vec3 &to, LedgeProbes::Vec3 &hit)
+        {
+            ++counters.rays;
+            return world.Pick(from, to, hit);
+        }
+
+        void Marker(int &, const LedgeProbes::Vec3 &) {}
+    };
+
+    enum class Kernel
+    {
+        kRing,
+        kAdaptive,
+        kSweep,
+        kReduced
+    };
+
+    template <class C>
+    bool RunKernel(Kernel kernel, C &context, const LedgeProbes::Params &params, const LedgeProbes::Input &input, LedgeProbes::Output &output)
+    {
+        switch (kernel)
+        {
+        case Kernel::kAdaptive:
+            return LedgeProbes::ProbeAdaptive(context, params, input, output);
+        case Kernel::kSweep:
+            return LedgeProbes::ProbeSweep(context, params, input, output);
+        case Kernel::kReduced:
+            return LedgeProbes::ProbeRing(context, params, input, output, true);
+        default:
+            return LedgeProbes::ProbeRing(context, params, input, output);
+        }
+    }
+
+    // Walking actors spread over a few dozen plateaus, standing on the ground.
+    struct Actor
+    {
+        LedgeProbes::Input input;
+        LedgeProbes::Output output;
+    };
+
+    std::vector<Actor> MakeActors(const SyntheticWorld &world, std::size_t count)
+    {
+        std::vector<Actor> actors;
+        std::uint32_t random = 12345;
+        auto next = [&random] {
+            random = random * 1664525u + 1013904223u;
+            return static_cast<float>(random >> 8) / static_cast<float>(1u << 24);
+        };
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float x = next() * 8.0f * SyntheticWorld::cell_size;
+            const float y = next() * 8.0f * SyntheticWorld::cell_size;
+            const float yaw = next() * 2.0f * static_cast<float>(LedgeProbes::pi);
+            actors.push_back({{{x, y, world.Height(x, y)}, {std::sin(yaw), std::cos(yaw), 0.0f}, yaw}, {}});
+        }
+        return actors;
+    }
+
+    struct Benchmark
+    {
+        std::string name;
+        // Runs the operation the given number of times and returns the rays it cast. Setup belongs
+        // outside, a run should only allocate what the operation does.
+        std::function<std::uint64_t(std::uint64_t)> run;
+        std::uint64_t ops_per_run = 1; // Operations per iteration, a decision tick has one per actor
+    };
+
+    volatile float g_sink = 0.0f; // Keeps results alive
+
+    constexpr std::string_view reference_name = "reference/machine";
+
+    std::vector<Benchmark> MakeBenchmarks()
+    {
+        static const SyntheticWorld world;
+        static LedgeProbes::Params params = [] {
+            LedgeProbes::Params p;
+            p.Derive();
+            return p;
+        }();
+        std::vector<Benchmark> benchmarks;
+
+        // No plugin code, the times of the others are scaled by how fast this ran
+        benchmarks.push_back({std::string(reference_name), [](std::uint64_t n) {
+                                  std::uint32_t random = 1;
+                                  float sum = 0.0f;
+                                  for (std::uint64_t i = 0; i < n; ++i)
+                                  {
+                                      for (int j = 0; j < 64; ++j)
+                                      {
+                                          random = random * 1664525u + 1013904223u;
+                                          sum += std::sqrt(static_cast<float>(random >> 8));
+                                      }
+                                  }
+                                  g_sink = sum;
+                                  return std::uint64_t(0);
+                              }});
+        benchmarks.push_back({"math/AverageAngles", [angles = std::vector<float>{0.1f, 0.4f, 0.6f, 6.1f, 0.3f}](std::uint64_t n) {
+                                  float sum = 0.0f;
+                                  for (std::uint64_t i = 0; i < n; ++i)
+                                      sum += LedgeProbes::AverageAngles(angles);
+                                  g_sink = sum;
+                                  return std::uint64_t(0);
+                              }});
+        benchmarks.push_back({"math/NormalizeAngle", [](std::uint64_t n) {
+                                  float sum = 0.0f;
+                                  for (std::uint64_t i = 0; i < n; ++i)
+                                      sum += LedgeProbes::NormalizeAngle(static_cast<float>(i & 1023) * 0.01f - 5.0f);
+                                  g_sink = sum;
+                                  return std::uint64_t(0);
+                              }});
+        benchmarks.push_back({"math/IsMaxMinZPastDropThreshold",
+                              [hit_z = std::vector<float>{-12.0f, -30.0f, -160.0f, -8.0f}, op_hit_z = std::vector<float>{-2.0f, 4.0f, -1.0f}](std::uint64_t n) {
+                                  int count = 0;
+                                  for (std::uint64_t i = 0; i < n; ++i)
+                                      count += LedgeProbes::IsMaxMinZPastDropThreshold(hit_z, op_hit_z, static_cast<float>(i & 7), params);
+                                  g_sink = static_cast<float>(count);
+                                  return std::uint64_t(0);
+                              }});
+
+        const std::pair<const char *, Kernel> kernels[] = {{"ring", Kernel::kRing}, {"adaptive", Kernel::kAdaptive}, {"sweep", Kernel::kSweep}, {"reduced", Kernel::kReduced}};
+        for (const auto &[kernel_name, kernel] : kernels)
+        {
+            // One iteration turns through 64 movement directions, every run averages over the same set
+            benchmarks.push_back({std::string("pattern/") + kernel_name,
+                                  [kernel](std::uint64_t n) {
+                                      Counters counters;
+                                      FlatContext<false> context{counters};
+                                      LedgeProbes::Output output;
+                                      int count = 0;
+                                      for (std::uint64_t i = 0; i < n; ++i)
+                                      {
+                                          for (int d = 0; d < 64; ++d)
+                                          {
+                                              const float yaw = static_cast<float>(d) * 0.1f;
+                                              const LedgeProbes::Input input{{0.0f, 0.0f, 0.0f}, {std::sin(yaw), std::cos(yaw), 0.0f}, yaw * 0.5f};
+                                              count += RunKernel(kernel, context, params, input, output);
+                                          }
+                                      }
+                                      g_sink = static_cast<float>(count);
+                                      return counters.rays;
+                                  },
+                                  64});
+        }
+
+        for (const std::size_t actor_count : {1, 10, 100, 1000})
+        {
+            for (const auto &[kernel_name, kernel] : kernels)
+            {
+                for (const bool two_phase : {false, true})
+                {
+                    const std::string name = std::string("decision/") + kernel_name + (two_phase ? "+two-phase/" : "/") + std::to_string(actor_count);
+                    benchmarks.push_back({name,
+                                          [kernel, two_phase, actors = MakeActors(world, actor_count)](std::uint64_t n) mutable {
+                                              Counters counters;
+                                              WorldContext<false> context{world, counters};
+                                              WorldContext<true> two_phase_context{world, counters};
+                                              int count = 0;
+                                              for (std::uint64_t i = 0; i < n; ++i)
+                                              {
+                                                  for (auto &actor : actors)
+                                                  {
+                                                      if (two_phase)
+                                                          count += RunKernel(kernel, two_phase_context, params, actor.input, actor.output);
+                                                      else
+                                                          count += RunKernel(kernel, context, params, actor.input, actor.output);
+                                                  }
+                                              }
+                                              g_sink = static_cast<float>(count);
+                                              return counters.rays;
+                                          },
+                                          actor_count});
+                }
+            }
+        }
+
+        return benchmarks;
+    }
+
+    struct Result
+    {
+        double ns_per_op = 0.0;
+        double allocs_per_op = 0.0;
+        double rays_per_op = 0.0;
+        double missed_ledges = 0.0; // Ring ledges the kernel doesn't find, decision rows only
+    };
+
+    constexpr std::size_t coverage_actors = 20000;
+
+    // A kernel's decisions next to the ring's for the same fresh actors.
+    struct Agreement
+    {
+        std::size_t agreeing = 0;
+        std::size_t ring_ledges = 0;
+        std::size_t missed = 0; // Found by the ring only
+        std::size_t extra = 0;  // Found by the kernel only
+    };
+
+    // Decides once for each of N fresh actors with kernel and with the ring.
+    Agreement CompareWithRing(Kernel kernel, bool two_phase, std::size_t actor_count)
+    {
+        static const SyntheticWorld world;
+        LedgeProbes::Params params;
+        params.Derive();
+        Counters counters;
+        WorldContext<false> context{world, counters};
+        WorldContext<true> two_phase_context{world, counters};
+        Agreement agreement;
+        for (auto &actor : MakeActors(world, actor_count))
+        {
+            LedgeProbes::Output ring_output;
+            const bool ring = RunKernel(Kernel::kRing, context, params, actor.input, ring_output);
+            const bool ledge = two_phase ? RunKernel(kernel, two_phase_context, params, actor.input, actor.output)
+                                         : RunKernel(kernel, context, params, actor.input, actor.output);
+            agreement.agreeing += ledge == ring;
+            agreement.ring_ledges += ring;
+            agreement.missed += ring && !ledge;
+            agreement.extra += ledge && !ring;
+        }
+        return agreement;
+    }
+
+    // Prints the ring agreement of every decision row that ran, and fills in the ring ledges its
+    // kernel misses for coverage_actors actors.
+    void CheckAgreement(std::vector<std::pair<std::string, Result>> &results)
+    {
+        const std::pair<const char *, Kernel> kernels[] = {{"ring", Kernel::kRing}, {"adaptive", Kernel::kAdaptive}, {"sweep", Kernel::kSweep}, {"reduced", Kernel::kReduced}};
+        std::map<std::string, Agreement> coverage; // Per variant, the same for every actor count
+        for (auto &[name, result] : results)
+        {
+            if (!name.starts_with("decision/"))
+                continue;
+            const std::string variant = name.substr(9, name.rfind('/') - 9);
+            const bool two_phase = variant.ends_with("+two-phase");
+            const std::string kind = two_phase ? variant.substr(0, variant.size() - 10) : variant;
+            const std::size_t actor_count = std::strtoul(name.c_str() + name.rfind('/') + 1, nullptr, 10);
+            for (const auto &[kernel_name, kernel] : kernels)
+            {
+                if (kind != kernel_name || (kernel == Kernel::kRing && !two_phase))
+                    continue;
+                const Agreement agreement = CompareWithRing(kernel, two_phase, actor_count);
+                std::printf("agreement  %-40s %5zu of %5zu decisions match the ring (%.1f%%)\n", name.c_str(), agreement.agreeing, actor_count,
+                            100.0 * static_cast<double>(agreement.agreeing) / static_cast<double>(actor_count));
+                if (!coverage.contains(variant))
+                {
+                    const Agreement covered = CompareWithRing(kernel, two_phase, coverage_actors);
+                    std::printf("coverage   %-40s %5zu of %5zu ring ledges missed, %zu found only here, of %zu actors\n", variant.c_str(), covered.missed,
+                                covered.ring_ledges, covered.extra, coverage_actors);
+                    coverage[variant] = covered;
+                }
+                result.missed_ledges = static_cast<double>(coverage[variant].missed);
+            }
+        }
+    }
+
+    // Doubles the iterations until a run lasts min_time, then repeats that run and reports the
+    // fastest. Interference only ever slows a run down.
+    Result Measure(const Benchmark &benchmark, double min_time, long repetitions)
+    {
+        auto run = [&](std::uint64_t iterations, double &seconds) {
+            const std::uint64_t allocations = g_allocations;
+            const auto start = std::chrono::steady_clock::now();
+            const std::uint64_t rays = benchmark.run(iterations);
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const double ops = static_cast<double>(iterations * benchmark.ops_per_run);
+            return Result{seconds * 1e9 / ops, static_cast<double>(g_allocations - allocations) / ops, static_cast<double>(rays) / ops, 0.0};
+        };
+        std::uint64_t iterations = 1;
+        double seconds = 0.0;
+        Result best = run(iterations, seconds);
+        while (seconds < min_time && iterations < (1ull << 40))
+        {
+            iterations *= 2;
+            best = run(iterations, seconds);
+        }
+        for (long i = 1; i < repetitions; ++i)
+        {
+            const Result result = run(iterations, seconds);
+            if (result.ns_per_op < best.ns_per_op)
+                best = result;
+        }
+        return best;
+    }
+
+    struct Tolerances
+    {
+        double time = 0.5;
+        double allocs = 0.5;
+        double rays = 0.0;
+        double missed = 0.0;
+    };
+
+    struct BaselineEntry
+    {
+        Result result;
+        Tolerances tolerances;
+    };
+
+    // Reads the few JSON shapes a results file uses: objects, arrays, strings and numbers.
+    class JsonReader
+    {
+    public:
+        explicit JsonReader(std::string text) : text(std::move(text)) {}
+
+        bool Expect(char c)
+        {
+            SkipSpace();
+            if (position >= text.size() || text[position] != c)
+                return false;
+            ++position;
+            return true;
+        }
+
+        // Consumes c if it is next.
+        bool Accept(char c)
+        {
+            SkipSpace();
+            if (position < text.size() && text[position] == c)
+            {
+                ++position;
+                return true;
+            }
+            return false;
+        }
+
+        bool String(std::string &value)
+        {
+            if (!Expect('"'))
+                return false;
+            value.clear();
+            while (position < text.size() && text[position] != '"')
+            {
+                if (text[position] == '\\' && position + 1 < text.size())
+                    ++position;
+                value += text[position++];
+            }
+            return Expect('"');
+        }
+
+        bool Number(double &value)
+        {
+            SkipSpace();
+            char *end = nullptr;
+            value = std::strtod(text.c_str() + position, &end);
+            if (end == text.c_str() + position)
+                return false;
+            position = static_cast<std::size_t>(end - text.c_str());
+            return true;
+        }
+
+    private:
+        void SkipSpace()
+        {
+            while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+                ++position;
+        }
+
+        std::string text;
+        std::size_t position = 0;
+    };
+
+    bool ReadTolerance(const std::string &key, double value, Tolerances &tolerances)
+    {
+        if (key == "time_tolerance")
+            tolerances.time = value;
+        else if (key == "alloc_tolerance")
+            tolerances.allocs = value;
+        else if (key == "ray_tolerance")
+            tolerances.rays = value;
+        else if (key == "missed_tolerance")
+            tolerances.missed = value;
+        else
+            return false;
+        return true;
+    }
+
+    // {"time_tolerance": 0.5, ..., "benchmarks": [{"name": "...", "ns_per_op": 1.0, ...}, ...]}
+    bool ReadBaseline(const std::string &path, std::map<std::string, BaselineEntry> &baseline)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            std::fprintf(stderr, "error: cannot open %s\n", path.c_str());
+            return false;
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        JsonReader reader(text.str());
+        Tolerances defaults;
+        std::vector<std::pair<std::string, BaselineEntry>> entries;
+        std::vector<std::map<std::string, double>> overrides;
+        bool ok = reader.Expect('{');
+        while (ok && !reader.Accept('}'))
+        {
+            std::string key;
+            ok = reader.String(key) && reader.Expect(':');
+            if (ok && key == "benchmarks")
+            {
+                ok = reader.Expect('[');
+                while (ok && !reader.Accept(']'))
+                {
+                    std::string name;
+                    std::map<std::string, double> fields;
+                    ok = reader.Expect('{');
+                    while (ok && !reader.Accept('}'))
+                    {
+                        std::string field;
+                        ok = reader.String(field) && reader.Expect(':');
+                        double value = 0.0;
+                        if (ok && field == "name")
+                            ok = reader.String(name);
+                        else if (ok)
+                        {
+                            ok = reader.Number(value);
+                            fields[field] = value;
+                        }
+                        reader.Accept(',');
+                    }
+                    entries.push_back({name, {}});
+                    overrides.push_back(std::move(fields));
+                    reader.Accept(',');
+                }
+            }
+            else if (ok)
+            {
+                double value = 0.0;
+                ok = reader.Number(value) && ReadTolerance(key, value, defaults);
+            }
+            reader.Accept(',');
+        }
+        if (!ok)
+        {
+            std::fprintf(stderr, "error: %s is not a ledgebench results file\n", path.c_str());
+            return false;
+        }
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            auto &entry = entries[i].second;
+            entry.tolerances = defaults;
+            for (const auto &[field, value] : overrides[i])
+            {
+                if (field == "ns_per_op")
+                    entry.result.ns_per_op = value;
+                else if (field == "allocs_per_op")
+                    entry.result.allocs_per_op = value;
+                else if (field == "rays_per_op")
+                    entry.result.rays_per_op = value;
+                else if (field == "missed_ledges")
+                    entry.result.missed_ledges = value;
+                else
+                    ReadTolerance(field, value, entry.tolerances);
+            }
+            baseline[entries[i].first] = entry;
+        }
+        return true;
+    }
+
+    bool WriteResults(const std::string &path, const std::vector<std::pair<std::string, Result>> &results)
+    {
+        const Tolerances defaults;
+        std::ofstream out(path);
+        out << "{\n";
+        out << "    \"time_tolerance\": " << defaults.time << ",\n";
+        out << "    \"alloc_tolerance\": " << defaults.allocs << ",\n";
+        out << "    \"ray_tolerance\": " << defaults.rays << ",\n";
+        out << "    \"missed_tolerance\": " << defaults.missed << ",\n";
+        out << "    \"benchmarks\": [\n";
+        char line[256];
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &[name, result] = results[i];
+            std::snprintf(line, sizeof(line),
+                          "        {\"name\": \"%s\", \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f, \"rays_per_op\": %.4f, \"missed_ledges\": %.0f}%s\n",
+                          name.c_str(), result.ns_per_op, result.allocs_per_op, result.rays_per_op, result.missed_ledges, i + 1 < results.size() ? "," : "");
+            out << line;
+        }
+        out << "    ]\n}\n";
+        if (!out)
+        {
+            std::fprintf(stderr, "error: cannot write %s\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool Selected(const std::string &name, const std::string &filter)
+    {
+        return name == reference_name || filter.empty() || name.find(filter) != std::string::npos;
+    }
+
+    // Prints every metric that got worse than its tolerance allows and every selected baseline
+    // benchmark that didn't run, returns how many there were, slower times not included.
+    int CompareWithBaseline(const std::vector<std::pair<std::string, Result>> &results, const std::map<std::string, BaselineEntry> &baseline,
+                            const std::string &filter)
+    {
+        // Rays are exact, the slack only absorbs float noise in a ray count averaged over actors
+        constexpr double ray_slack = 0.01;
+        // The fastest benchmarks take a few nanoseconds, timer noise alone exceeds any tolerance
+        constexpr double time_slack = 5.0;
+        int regressions = 0;
+        auto print = [](const char *label, const std::string &name, const char *metric, double base, double current, double tolerance) {
+            std::printf("%-10s %-40s %-14s %12.3f -> %12.3f (+%.1f%%, tolerance %.1f%%)\n", label, name.c_str(), metric, base, current,
+                        base > 0.0 ? (current / base - 1.0) * 100.0 : 100.0, tolerance * 100.0);
+        };
+        auto report = [&](const std::string &name, const char *metric, double base, double current, double tolerance) {
+            print("REGRESSION", name, metric, base, current, tolerance);
+            ++regressions;
+        };
+
+        // Times are scaled to the machine that wrote the baseline
+        double machine_scale = 1.0;
+        const auto reference = std::ranges::find(results, reference_name, &std::pair<std::string, Result>::first);
+        const auto base_reference = baseline.find(std::string(reference_name));
+        if (reference != results.end() && base_reference != baseline.end() && reference->second.ns_per_op > 0.0)
+            machine_scale = base_reference->second.result.ns_per_op / reference->second.ns_per_op;
+        else
+            std::printf("no %s in both the run and the baseline, times compared unscaled\n", reference_name.data());
+
+        for (const auto &[name, result] : results)
+        {
+            const auto it = baseline.find(name);
+            if (it == baseline.end())
+            {
+                std::printf("new        %s, not in the baseline\n", name.c_str());
+                continue;
+            }
+            const auto &[base, tolerances] = it->second;
+            if (name != reference_name)
+            {
+                const double scaled = result.ns_per_op * machine_scale;
+                if (scaled > base.ns_per_op * (1.0 + tolerances.time) + time_slack)
+                    print("slower", name, "ns/op scaled", base.ns_per_op, scaled, tolerances.time);
+            }
+            if (result.allocs_per_op > std::ceil(base.allocs_per_op * (1.0 + tolerances.allocs)))
+                report(name, "allocs/op", base.allocs_per_op, result.allocs_per_op, tolerances.allocs);
+            if (result.rays_per_op > base.rays_per_op * (1.0 + tolerances.rays) + ray_slack)
+                report(name, "rays/op", base.rays_per_op, result.rays_per_op, tolerances.rays);
+            if (result.missed_ledges > base.missed_ledges + tolerances.missed)
+                report(name, "missed ledges", base.missed_ledges, result.missed_ledges, base.missed_ledges > 0.0 ? tolerances.missed / base.missed_ledges : 0.0);
+        }
+        for (const auto &[name, entry] : baseline)
+        {
+            if (Selected(name, filter) && std::ranges::find(results, name, &std::pair<std::string, Result>::first) == results.end())
+            {
+                std::printf("MISSING    %s, in the baseline but not run\n", name.c_str());
+                ++regressions;
+            }
+        }
+        return regressions;
+    }
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr, "usage: ledgebench [--filter <text>] [--min-time <seconds>] [--repetitions <n>] [--json <out.json>]\n"
+                             "                  [--baseline <baseline.json>]\n");
+    }
+
+    bool ParseFloat(const char *text, double &value)
+    {
+        char *end = nullptr;
+        value = std::strtod(text, &end);
+        return end && *end == '\0' && value > 0.0;
+    }
+
+    bool ParseCount(const char *text, long &value)
+    {
+        char *end = nullptr;
+        value = std::strtol(text, &end, 10);
+        return end && *end == '\0' && value > 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value)
+            options.filter = argv[++i];
+        else if (arg == "--min-time" && has_value && ParseFloat(argv[++i], options.min_time))
+            continue;
+        else if (arg == "--repetitions" && has_value && ParseCount(argv[++i], options.repetitions))
+            continue;
+        else if (arg == "--json" && has_value)
+            options.json = argv[++i];
+        else if (arg == "--baseline" && has_value)
+            options.baseline = argv[++i];
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    // Read first, a bad baseline shouldn't cost a whole run
+    std::map<std::string, BaselineEntry> baseline;
+    if (!options.baseline.empty() && !ReadBaseline(options.baseline, baseline))
+        return 2;
+
+    std::vector<std::pair<std::string, Result>> results;
+    std::printf("%-40s %14s %12s %12s\n", "benchmark", "ns/op", "allocs/op", "rays/op");
+    for (const auto &benchmark : MakeBenchmarks())
+    {
+        if (!Selected(benchmark.name, options.filter))
+            continue;
+        const Result result = Measure(benchmark, options.min_time, options.repetitions);
+        std::printf("%-40s %14.1f %12.2f %12.2f\n", benchmark.name.c_str(), result.ns_per_op, result.allocs_per_op, result.rays_per_op);
+        results.emplace_back(benchmark.name, result);
+    }
+
+    CheckAgreement(results);
+
+    if (!options.json.empty() && !WriteResults(options.json, results))
+        return 2;
+    if (options.baseline.empty())
+        return 0;
+    const int regressions = CompareWithBaseline(results, baseline, options.filter);
+    std::printf("%d regressions against %s\n", regressions, options.baseline.c_str());
+    return regressions ? 1 : 0;
+}
\ No newline at end of file
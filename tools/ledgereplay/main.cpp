@@ -0,0 +1,403 @@
+// ledgereplay: replays a recorded .replay log through two probe variants and compares their decisions.
+//
+//   ledgereplay [options] <AnimationLedgeBlockNG.replay>
+//
+// Every recorded pick becomes a sample of a replay world: ground at the hit, or no ground above the
+// end of a miss. Slanted picks are sampled along their path. A variant's rays are answered from the
+// nearest samples, rays no sample answers are unresolved, so the world is only exact where a variant
+// casts the rays that were recorded. Decisions that cast an unresolved ray are counted apart and not
+// compared. Variants are ring, adaptive, sweep or reduced, with +two-phase for two-phase rays. Options:
+//   --a <variant>              Reference variant, compared with the recorded decisions (the recorded kernel)
+//   --b <variant>              Variant under test (adaptive)
+//   --max-divergences <n>      Decisions A and B may disagree on before the exit code is 1 (0)
+//   --list <n>                 Divergences printed (20)
+//   --drop-threshold <units>   Overrides the tuning recorded in the log, likewise
+//   --ledge-distance <units>   --ground-leeway and --refine-steps
+
+#include "LedgeProbes.h"
+#include "ReplayLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    constexpr float sample_spacing = 8.0f; // Slanted picks are sampled this far apart
+    constexpr float cell_size = 8.0f;
+    constexpr float match_radius = 12.0f; // Samples further from a ray don't answer it
+
+    // What a recorded pick saw at one position: ground at z, or for a miss no ground above z.
+    struct Sample
+    {
+        float x, y, z;
+        bool ground;
+    };
+
+    class ReplayWorld
+    {
+    public:
+        void AddProbe(const ReplayLog::Probe &probe)
+        {
+            const float dx = probe.to.x - probe.from.x;
+            const float dy = probe.to.y - probe.from.y;
+            const float dz = probe.to.z - probe.from.z;
+            const float fraction = std::min(probe.hit_fraction, 1.0f);
+            const float horizontal = std::sqrt(dx * dx + dy * dy) * fraction;
+            // Nothing along the pick before the hit, everything under a slanted pick's path is open
+            const int steps = static_cast<int>(horizontal / sample_spacing);
+            for (int s = 1; s <= steps; ++s)
+            {
+                const float t = fraction * s / (steps + 1);
+                Add({probe.from.x + dx * t, probe.from.y + dy * t, probe.from.z + dz * t, false});
+            }
+            Add({probe.from.x + dx * fraction, probe.from.y + dy * fraction, probe.from.z + dz * fraction, probe.hit_fraction < 1.0f});
+        }
+
+        std::size_t SampleCount() const { return sample_count; }
+
+        // Ground under (x, y) between top and bottom. 1 hit with z set, 0 miss, -1 no sample answers.
+        int Query(float x, float y, float top, float bottom, float &z) const
+        {
+            const Sample *best = nullptr;
+            float best_distance = match_radius * match_radius;
+            const long cx = Cell(x);
+            const long cy = Cell(y);
+            for (long gy = cy - 1; gy <= cy + 1; ++gy)
+            {
+                for (long gx = cx - 1; gx <= cx + 1; ++gx)
+                {
+                    const auto it = cells.find(Key(gx, gy));
+                    if (it == cells.end())
+                        continue;
+                    for (const auto &sample : it->second)
+                    {
+                        // A miss only answers rays that end above where it ended
+                        if (!sample.ground && bottom < sample.z)
+                            continue;
+                        const float distance = (sample.x - x) * (sample.x - x) + (sample.y - y) * (sample.y - y);
+                        if (distance < best_distance)
+                        {
+                            best = &sample;
+                            best_distance = distance;
+                        }
+                    }
+                }
+            }
+            if (!best)
+                return -1;
+            if (!best->ground || best->z < bottom)
+                return 0;
+            z = std::min(best->z, top);
+            return 1;
+        }
+
+    private:
+        static long Cell(float value) { return static_cast<long>(std::floor(value / cell_size)); }
+
+        static std::uint64_t Key(long x, long y) { return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y); }
+
+        void Add(const Sample &sample)
+        {
+            cells[Key(Cell(sample.x), Cell(sample.y))].push_back(sample);
+            ++sample_count;
+        }
+
+        std::unordered_map<std::uint64_t, std::vector<Sample>> cells;
+        std::size_t sample_count = 0;
+    };
+
+    struct Counters
+    {
+        std::size_t rays = 0;
+        std::size_t unresolved = 0;
+    };
+
+    // Answers a variant's rays from the replay world.
+    template <bool TwoPhase>
+    struct ReplayContext
+    {
+        static constexpr bool two_phase_rays = TwoPhase;
+
+        const ReplayWorld &world;
+        Counters &counters;
+
+        bool Cast(const LedgeProbes::Vec3 &from, float length, LedgeProbes::Vec3 &hit)
+        {
+            ++counters.rays;
+            float z;
+            const int answer = world.Query(from.x, from.y, from.z, from.z - length, z);
+            if (answer < 0)
+                ++counters.unresolved;
+            if (answer <= 0)
+                return false;
+            hit = {from.x, from.y, z};
+            return true;
+        }
+
+        bool Pick(const LedgeProbes::Vec3 &from, const LedgeProbes::Vec3 &to, LedgeProbes::Vec3 &hit)
+        {
+            ++counters.rays;
+            const LedgeProbes::Vec3 delta = to - from;
+            const int steps = std::max(1, static_cast<int>(std::sqrt(delta.x * delta.x + delta.y * delta.y) / (sample_spacing * 0.5f)));
+            bool unresolved = false;
+            for (int s = 0; s <= steps; ++s)
+            {
+                const LedgeProbes::Vec3 point = from + delta * (static_cast<float>(s) / steps);
+                float z;
+                const int answer = world.Query(point.x, point.y, from.z, point.z, z);
+                if (answer < 0)
+                    unresolved = true;
+                if (answer > 0)
+                {
+                    hit = {point.x, point.y, z};
+                    return true;
+                }
+            }
+            if (unresolved)
+                ++counters.unresolved;
+            return false;
+        }
+
+        void Marker(int &, const LedgeProbes::Vec3 &) {}
+    };
+
+    using KernelFn = bool (*)(const ReplayWorld &, Counters &, const LedgeProbes::Params &, const LedgeProbes::Input &, LedgeProbes::Output &);
+
+    template <bool TwoPhase, int Kind>
+    bool RunKernel(const ReplayWorld &world, Counters &counters, const LedgeProbes::Params &params, const LedgeProbes::Input &input, LedgeProbes::Output &output)
+    {
+        ReplayContext<TwoPhase> context{world, counters};
+        if constexpr (Kind == 3)
+            return LedgeProbes::ProbeRing(context, params, input, output, true);
+        else if constexpr (Kind == 2)
+            return LedgeProbes::ProbeSweep(context, params, input, output);
+        else if constexpr (Kind == 1)
+            return LedgeProbes::ProbeAdaptive(context, params, input, output);
+        else
+            return LedgeProbes::ProbeRing(context, params, input, output);
+    }
+
+    struct Variant
+    {
+        std::string name;
+        KernelFn kernel = nullptr;
+        Counters counters;
+        std::size_t ledges = 0;
+        double seconds = 0.0;
+        std::unordered_map<std::uint32_t, LedgeProbes::Output> outputs; // Carried per actor like ActorState
+    };
+
+    std::string KernelName(std::uint32_t kernel)
+    {
+        const auto kind = kernel & ~ReplayLog::kTwoPhaseKernel;
+        std::string name = kind == ReplayLog::kReducedKernel  ? "reduced"
+                           : kind == ReplayLog::kSweepKernel  ? "sweep"
+                           : kind == ReplayLog::kAdaptiveKernel ? "adaptive"
+                                                                : "ring";
+        if (kernel & ReplayLog::kTwoPhaseKernel)
+            name += "+two-phase";
+        return name;
+    }
+
+    bool ParseVariant(const std::string &name, Variant &variant)
+    {
+        const bool two_phase = name.ends_with("+two-phase");
+        const std::string kind = two_phase ? name.substr(0, name.size() - 10) : name;
+        static constexpr KernelFn kernels[2][4] = {{RunKernel<false, 0>, RunKernel<false, 1>, RunKernel<false, 2>, RunKernel<false, 3>},
+                                                   {RunKernel<true, 0>, RunKernel<true, 1>, RunKernel<true, 2>, RunKernel<true, 3>}};
+        const int index = kind == "ring" ? 0 : kind == "adaptive" ? 1 : kind == "sweep" ? 2 : kind == "reduced" ? 3 : -1;
+        if (index < 0)
+            return false;
+        variant.name = name;
+        variant.kernel = kernels[two_phase][index];
+        return true;
+    }
+
+    struct Options
+    {
+        std::string input;
+        std::string a; // Empty for the kernel the log was recorded with
+        std::string b = "adaptive";
+        long max_divergences = 0;
+        long list = 20;
+        float drop_threshold = 0.0f; // 0 keeps the recorded value
+        float ledge_distance = 0.0f;
+        float ground_leeway = 0.0f;
+        long refine_steps = -1;
+    };
+
+    bool Decide(Variant &variant, const ReplayWorld &world, const LedgeProbes::Params &params, const ReplayLog::ActorFrame &frame)
+    {
+        const LedgeProbes::Input input{{frame.probe_position.x, frame.probe_position.y, frame.probe_position.z},
+                                       {frame.move_direction.x, frame.move_direction.y, frame.move_direction.z},
+                                       frame.probe_yaw};
+        auto &output = variant.outputs[frame.actor_id];
+        const auto start = std::chrono::steady_clock::now();
+        const bool ledge = variant.kernel(world, variant.counters, params, input, output);
+        variant.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (ledge)
+            ++variant.ledges;
+        return ledge;
+    }
+
+    void PrintVariant(const Variant &variant, std::size_t decisions)
+    {
+        const double per_decision = decisions ? 1.0 / decisions : 0.0;
+        std::printf("%-20s %8zu ledges  %6.2f rays/decision  %8.3f us/decision  %zu unresolved rays\n", variant.name.c_str(), variant.ledges,
+                    variant.counters.rays * per_decision, variant.seconds * 1e6 * per_decision, variant.counters.unresolved);
+    }
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr,
+                     "usage: ledgereplay [--a <variant>] [--b <variant>] [--max-divergences N] [--list N]\n"
+                     "                   [--drop-threshold N] [--ledge-distance N] [--ground-leeway N] [--refine-steps N]\n"
+                     "                   <file.replay>\n"
+                     "variants: ring, adaptive, sweep, reduced, each optionally with +two-phase\n");
+    }
+
+    bool ParseFloat(const char *text, float &value)
+    {
+        char *end = nullptr;
+        value = std::strtof(text, &end);
+        return end && *end == '\0' && value > 0.0f;
+    }
+
+    bool ParseCount(const char *text, long &value)
+    {
+        char *end = nullptr;
+        value = std::strtol(text, &end, 10);
+        return end && *end == '\0' && value >= 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--a" && has_value)
+            options.a = argv[++i];
+        else if (arg == "--b" && has_value)
+            options.b = argv[++i];
+        else if (arg == "--max-divergences" && has_value && ParseCount(argv[++i], options.max_divergences))
+            continue;
+        else if (arg == "--list" && has_value && ParseCount(argv[++i], options.list))
+            continue;
+        else if (arg == "--drop-threshold" && has_value && ParseFloat(argv[++i], options.drop_threshold))
+            continue;
+        else if (arg == "--ledge-distance" && has_value && ParseFloat(argv[++i], options.ledge_distance))
+            continue;
+        else if (arg == "--ground-leeway" && has_value && ParseFloat(argv[++i], options.ground_leeway))
+            continue;
+        else if (arg == "--refine-steps" && has_value && ParseCount(argv[++i], options.refine_steps))
+            continue;
+        else if (!arg.starts_with("-") && options.input.empty())
+            options.input = arg;
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    Variant a;
+    Variant b;
+    if (options.input.empty() || (!options.a.empty() && !ParseVariant(options.a, a)) || !ParseVariant(options.b, b))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::ifstream in(options.input, std::ios::binary);
+    if (!in)
+    {
+        std::fprintf(stderr, "error: cannot open %s\n", options.input.c_str());
+        return 1;
+    }
+    std::vector<char> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const std::span<const std::byte> bytes(reinterpret_cast<const std::byte *>(raw.data()), raw.size());
+    ReplayLog::Decoder decoder;
+    if (!decoder.Open(bytes))
+    {
+        std::fprintf(stderr, "error: %s is not a version %u replay log\n", options.input.c_str(), ReplayLog::file_version);
+        return 1;
+    }
+
+    // The whole recording is the world, a variant may probe where a later tick recorded
+    std::vector<ReplayLog::Tick> ticks;
+    ReplayWorld world;
+    for (ReplayLog::Tick tick; decoder.Next(tick);)
+    {
+        for (const auto &actor : tick.actors)
+        {
+            for (const auto &probe : actor.probes)
+                world.AddProbe(probe);
+        }
+        ticks.push_back(std::move(tick));
+    }
+
+    const auto &header = decoder.Header();
+    if (options.a.empty() && !ParseVariant(KernelName(header.kernel), a))
+    {
+        std::fprintf(stderr, "error: %s was recorded with unknown kernel %#x\n", options.input.c_str(), header.kernel);
+        return 1;
+    }
+    LedgeProbes::Params params;
+    params.drop_threshold = options.drop_threshold > 0.0f ? options.drop_threshold : header.drop_threshold;
+    params.ledge_distance = options.ledge_distance > 0.0f ? options.ledge_distance : header.ledge_distance;
+    params.ground_leeway = options.ground_leeway > 0.0f ? options.ground_leeway : header.ground_leeway;
+    params.refine_steps = options.refine_steps >= 0 ? static_cast<int>(options.refine_steps) : header.refine_steps;
+    params.Derive();
+
+    std::size_t decisions = 0;
+    std::size_t unresolved_decisions = 0;
+    std::size_t recorded_mismatches = 0;
+    std::size_t divergences = 0;
+    for (const auto &tick : ticks)
+    {
+        for (const auto &actor : tick.actors)
+        {
+            if (!(actor.flags & ReplayLog::kProbed))
+                continue;
+            ++decisions;
+            const std::size_t unresolved = a.counters.unresolved + b.counters.unresolved;
+            const bool ledge_a = Decide(a, world, params, actor);
+            const bool ledge_b = Decide(b, world, params, actor);
+            // An unresolved ray reads as a miss, which leans towards a ledge, so the world can't judge these
+            if (a.counters.unresolved + b.counters.unresolved != unresolved)
+            {
+                ++unresolved_decisions;
+                continue;
+            }
+            if (ledge_a != static_cast<bool>(actor.flags & ReplayLog::kLedgeDetected))
+                ++recorded_mismatches;
+            if (ledge_a == ledge_b)
+                continue;
+            if (divergences < static_cast<std::size_t>(options.list))
+                std::printf("divergence: tick %llu actor %08X at (%.1f, %.1f, %.1f): %s %s, %s %s\n", static_cast<unsigned long long>(tick.index),
+                            actor.actor_id, actor.probe_position.x, actor.probe_position.y, actor.probe_position.z, a.name.c_str(),
+                            ledge_a ? "ledge" : "clear", b.name.c_str(), ledge_b ? "ledge" : "clear");
+            ++divergences;
+        }
+    }
+
+    std::printf("%s: %zu ticks, %zu decisions, %zu world samples, recorded with %s\n", options.input.c_str(), ticks.size(), decisions,
+                world.SampleCount(), KernelName(header.kernel).c_str());
+    std::printf("tuning: drop threshold %.1f, ledge distance %.1f, ground leeway %.1f, refine steps %d\n", params.drop_threshold,
+                params.ledge_distance, params.ground_leeway, params.refine_steps);
+    PrintVariant(a, decisions);
+    PrintVariant(b, decisions);
+    std::printf("%zu divergences, %zu recorded decisions differ from %s, %zu decisions with unresolved rays not compared\n", divergences,
+                recorded_mismatches, a.name.c_str(), unresolved_decisions);
+    return divergences > static_cast<std::size_t>(options.max_divergences) ? 1 : 0;
+}
\ No newline at end of file
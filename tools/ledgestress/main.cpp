@@ -0,0 +1,436 @@
+// ledgestress: headless large-battle simulation of the plugin's actor tracking and ledge checks.
+//
+//   ledgestress [options]
+//
+// Simulates actors entering and leaving combat on SyntheticWorld and firing start and end animation
+// events with game-like timing. The events and ticks go through the plugin's Tracking rules, the
+// ones CombatEventSink, AttackAnimationGraphEventSink, CheckAllActorsForLedges and CleanupActors
+// apply, and its LedgeProbes, on plain state instead of game objects. Prints the tracked state every
+// report interval and the per-tick latency distribution at the end. Options:
+//   --actors <n>            Simulated NPCs, the player comes on top (500)
+//   --seconds <s>           Simulated time at 60 ticks per second (120)
+//   --kernel <name>         ring, adaptive, sweep or reduced (ring)
+//   --lost-end-rate <p>     Chance that a move's end event never arrives, like an interrupted animation (0.05)
+//   --report-every <s>      Seconds of simulated time between progress lines (10)
+//   --seed <n>              Random seed (1)
+
+#include "AnimationTags.h"
+#include "LedgeProbes.h"
+#include "SyntheticWorld.h"
+#include "Tracking.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    constexpr float tick_seconds = 1.0f / 60.0f;
+    constexpr float cleanup_seconds = 10.0f;   // PlayerUpdateListener::timeBetweenCleaning
+    constexpr float jump_duration = 1.5f;      // Config defaults, with Teleport on
+    constexpr int memory_duration = 10;
+    constexpr float valid_safe_point_distance = 10.0f;
+    constexpr std::uint32_t player_id = 0x14;
+
+    struct Options
+    {
+        long actors = 500;
+        float seconds = 120.0f;
+        std::string kernel = "ring";
+        float lost_end_rate = 0.05f;
+        float report_every = 10.0f;
+        long seed = 1;
+    };
+
+    // Globals::ActorState without the game objects, what the Tracking rules read and write
+    struct ActorState
+    {
+        bool is_attacking = false;
+        bool is_on_ledge = false;
+        int loops = 0;
+        float best_yaw = 0.0f;
+        float ledge_lip_distance = 0.0f;
+        int animation_type = 0;
+        float jump_start = 0.0f;
+        bool is_jumping = false;
+        std::vector<LedgeProbes::Vec3> safe_grounded_positions;
+    };
+
+    // A start tag and the event that ends its move, tag or payload.
+    struct Move
+    {
+        const char *start;
+        const char *end_tag;
+        const char *end_payload;
+    };
+
+    constexpr Move moves[] = {{"PowerAttack_Start_end", "attackStop", ""},
+                              {"MCO_DodgeInitiate", "", "$DMCO_Reset"},
+                              {"RollTrigger", "RollStop", ""},
+                              {"SidestepTrigger", "RollStop", ""},
+                              {"TKDR_DodgeStart", "TKDR_DodgeEnd", ""},
+                              {"MCO_DisableSecondDodge", "EnableBumper", ""},
+                              {"SlideStart", "SlideStop", ""}};
+
+    // What the game would be doing with one actor.
+    struct SimActor
+    {
+        std::uint32_t form_id = 0;
+        bool player = false;
+        bool in_combat = false;
+        float combat_toggle_time = 0.0f; // Enters or leaves combat then
+        float next_move_time = 0.0f;
+        float move_end_time = -1.0f; // Negative while no end event is pending
+        const Move *move = nullptr;
+        LedgeProbes::Vec3 position;
+        float heading = 0.0f;
+    };
+
+    struct Latencies
+    {
+        std::vector<double> events;
+        std::vector<double> checks;
+        std::vector<double> cleanup;
+        std::vector<double> total;
+    };
+
+    double Percentile(std::vector<double> values, double fraction)
+    {
+        if (values.empty())
+            return 0.0;
+        const auto index = static_cast<std::size_t>(fraction * (values.size() - 1));
+        std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(index));
+        return values[index];
+    }
+
+    class Simulation
+    {
+    public:
+        explicit Simulation(const Options &options) : options(options), random(static_cast<std::uint32_t>(options.seed))
+        {
+            params.Derive();
+            actors.resize(static_cast<std::size_t>(options.actors) + 1);
+            for (std::size_t i = 0; i < actors.size(); ++i)
+            {
+                auto &actor = actors[i];
+                actor.form_id = player_id + static_cast<std::uint32_t>(i) * 0x101u;
+                actor.player = i == 0;
+                actor.position.x = Uniform(0.0f, 16.0f * SyntheticWorld::cell_size);
+                actor.position.y = Uniform(0.0f, 16.0f * SyntheticWorld::cell_size);
+                actor.position.z = world.Height(actor.position.x, actor.position.y);
+                actor.heading = Uniform(0.0f, 2.0f * static_cast<float>(LedgeProbes::pi));
+                // Combatants join over the first ten seconds, the player is tracked from the start
+                actor.combat_toggle_time = actor.player ? 0.0f : Uniform(0.0f, 10.0f);
+                actor.next_move_time = Uniform(0.5f, 3.0f);
+            }
+            states[player_id];
+        }
+
+        void Run()
+        {
+            float next_report = options.report_every;
+            float next_cleanup = cleanup_seconds;
+            const auto ticks = static_cast<long>(options.seconds / tick_seconds);
+            std::printf("%8s %8s %10s %12s %10s %10s\n", "time", "tracked", "attacking", "safe points", "safe KiB", "tick ms");
+            for (long tick = 0; tick < ticks; ++tick)
+            {
+                now = tick * tick_seconds;
+                const auto start = Clock::now();
+                FireEvents();
+                const auto events_done = Clock::now();
+                CheckAllActorsForLedges();
+                const auto checks_done = Clock::now();
+                if (now >= next_cleanup)
+                {
+                    next_cleanup += cleanup_seconds;
+                    CleanupActors();
+                }
+                const auto end = Clock::now();
+                latencies.events.push_back(Milliseconds(start, events_done));
+                latencies.checks.push_back(Milliseconds(events_done, checks_done));
+                latencies.cleanup.push_back(Milliseconds(checks_done, end));
+                latencies.total.push_back(Milliseconds(start, end));
+                if (now >= next_report)
+                {
+                    next_report += options.report_every;
+                    Report();
+                }
+            }
+        }
+
+        void Summary() const
+        {
+            std::printf("\n%-8s %10s %10s %10s %10s %10s  (ms per tick)\n", "phase", "p50", "p90", "p99", "p99.9", "max");
+            const std::pair<const char *, const std::vector<double> *> phases[] = {
+                {"events", &latencies.events}, {"checks", &latencies.checks}, {"cleanup", &latencies.cleanup}, {"total", &latencies.total}};
+            for (const auto &[name, values] : phases)
+                std::printf("%-8s %10.4f %10.4f %10.4f %10.4f %10.4f\n", name, Percentile(*values, 0.5), Percentile(*values, 0.9),
+                            Percentile(*values, 0.99), Percentile(*values, 0.999), Percentile(*values, 1.0));
+            std::printf("\n%llu combat events, %llu cleanups visiting %.1f states each\n", static_cast<unsigned long long>(combat_events),
+                        static_cast<unsigned long long>(cleanups), cleanups ? static_cast<double>(cleanup_visits) / cleanups : 0.0);
+            std::printf("%llu decisions, %.2f rays per decision, %llu ledges\n", static_cast<unsigned long long>(decisions),
+                        decisions ? static_cast<double>(rays) / decisions : 0.0, static_cast<unsigned long long>(ledges));
+            std::printf("peak %zu tracked actors, peak %zu safe points on one actor\n", peak_tracked, peak_safe_points);
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        // Answers the probes from the synthetic world and counts their rays.
+        struct Context
+        {
+            static constexpr bool two_phase_rays = false;
+
+            const SyntheticWorld &world;
+            std::uint64_t &rays;
+
+            bool Cast(const LedgeProbes::Vec3 &from, float length, LedgeProbes::Vec3 &hit)
+            {
+                ++rays;
+                return world.Cast(from, length, hit);
+            }
+
+            bool Pick(const LedgeProbes::Vec3 &from, const LedgeProbes::Vec3 &to, LedgeProbes::Vec3 &hit)
+            {
+                ++rays;
+                return world.Pick(from, to, hit);
+            }
+
+            void Marker(int &, const LedgeProbes::Vec3 &) {}
+        };
+
+        bool Decide(Context &context, const LedgeProbes::Input &input, LedgeProbes::Output &output) const
+        {
+            if (options.kernel == "sweep")
+                return LedgeProbes::ProbeSweep(context, params, input, output);
+            if (options.kernel == "adaptive")
+                return LedgeProbes::ProbeAdaptive(context, params, input, output);
+            return LedgeProbes::ProbeRing(context, params, input, output, options.kernel == "reduced");
+        }
+
+        static double Milliseconds(Clock::time_point start, Clock::time_point end)
+        {
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        float Uniform(float low, float high)
+        {
+            return std::uniform_real_distribution<float>(low, high)(random);
+        }
+
+        SimActor *Find(std::uint32_t form_id)
+        {
+            return &actors[(form_id - player_id) / 0x101u];
+        }
+
+        // Moves the actors and fires the events that came due this tick.
+        void FireEvents()
+        {
+            for (auto &actor : actors)
+            {
+                if (!actor.player && now >= actor.combat_toggle_time)
+                {
+                    actor.in_combat = !actor.in_combat;
+                    // Fights last a while, lulls are shorter
+                    actor.combat_toggle_time = now + (actor.in_combat ? Uniform(20.0f, 90.0f) : Uniform(5.0f, 30.0f));
+                    OnCombatEvent(actor);
+                }
+                if (!actor.player && !actor.in_combat)
+                    continue;
+
+                const bool attacking = actor.move_end_time >= 0.0f;
+                const float speed = attacking ? 320.0f : 140.0f; // Lunges and dodges cover ground fast
+                actor.heading += Uniform(-0.05f, 0.05f);
+                actor.position.x = std::clamp(actor.position.x + std::sin(actor.heading) * speed * tick_seconds, 0.0f, 16.0f * SyntheticWorld::cell_size);
+                actor.position.y = std::clamp(actor.position.y + std::cos(actor.heading) * speed * tick_seconds, 0.0f, 16.0f * SyntheticWorld::cell_size);
+                actor.position.z = world.Height(actor.position.x, actor.position.y);
+
+                if (attacking && now >= actor.move_end_time)
+                {
+                    actor.move_end_time = -1.0f;
+                    if (Uniform(0.0f, 1.0f) >= options.lost_end_rate)
+                        OnAnimationEvent(actor, actor.move->end_tag, actor.move->end_payload);
+                }
+                if (now >= actor.next_move_time)
+                {
+                    actor.next_move_time = now + Uniform(1.5f, 5.0f);
+                    if (Uniform(0.0f, 1.0f) < 0.1f)
+                        OnAnimationEvent(actor, "JumpUp", "");
+                    else
+                    {
+                        actor.move = &moves[static_cast<std::size_t>(Uniform(0.0f, 1.0f) * std::size(moves)) % std::size(moves)];
+                        actor.move_end_time = now + Uniform(0.3f, 1.2f);
+                        OnAnimationEvent(actor, actor.move->start, "");
+                    }
+                }
+            }
+        }
+
+        // CombatEventSink::ProcessEvent
+        void OnCombatEvent(const SimActor &actor)
+        {
+            ++combat_events;
+            const auto change = Tracking::OnCombatEvent(states.contains(actor.form_id), actor.in_combat ? Tracking::CombatState::kCombat : Tracking::CombatState::kNone);
+            if (change == Tracking::CombatChange::kTrack)
+                states[actor.form_id];
+            else if (change == Tracking::CombatChange::kUntrack)
+                states.erase(actor.form_id);
+            peak_tracked = std::max(peak_tracked, states.size());
+        }
+
+        // AttackAnimationGraphEventSink::ProcessEvent
+        void OnAnimationEvent(const SimActor &actor, const char *tag, const char *payload)
+        {
+            const auto it = states.find(actor.form_id);
+            if (it != states.end())
+                Tracking::OnAnimationEvent(it->second, tag, payload, {}, now);
+        }
+
+        // Utils::CleanupActors
+        void CleanupActors()
+        {
+            ++cleanups;
+            cleanup_visits += Tracking::SweepStates(
+                states,
+                [this](std::uint32_t form_id) {
+                    const auto *actor = Find(form_id);
+                    return actor->player || actor->in_combat;
+                },
+                [this](auto it) { return states.erase(it); });
+        }
+
+        // Utils::CheckAllActorsForLedges with EdgeCheck's decision and bookkeeping
+        void CheckAllActorsForLedges()
+        {
+            for (auto &[form_id, state] : states)
+            {
+                if (!Tracking::WantsCheck(state, now - state.jump_start, jump_duration))
+                    continue;
+
+                auto &actor = *Find(form_id);
+                const LedgeProbes::Input input{actor.position, {std::sin(actor.heading), std::cos(actor.heading), 0.0f}, actor.heading};
+                LedgeProbes::Output output{state.best_yaw, state.ledge_lip_distance};
+                Context context{world, rays};
+                const bool ledge_detected = Decide(context, input, output);
+                state.best_yaw = output.best_yaw;
+                state.ledge_lip_distance = output.ledge_lip_distance;
+                ++decisions;
+
+                // FinishCheck, the simulated actors never leave the ground
+                Tracking::RecordDecision(state, memory_duration, ledge_detected, true, actor.position);
+                peak_safe_points = std::max(peak_safe_points, state.safe_grounded_positions.size());
+
+                // ApplyLedgeDecision and MoveActorToSafePoint
+                if (ledge_detected)
+                {
+                    ++ledges;
+                    if (const auto *safe_point = Tracking::NearSafePoint(state, actor.position, valid_safe_point_distance))
+                        actor.position = *safe_point;
+                    else
+                        actor.position = actor.position - LedgeProbes::Vec3(std::sin(state.best_yaw), std::cos(state.best_yaw), 0.0f) *
+                                                              Tracking::BackOff(state, params.ledge_distance);
+                    actor.heading += static_cast<float>(LedgeProbes::pi); // The AI turns away from the drop
+                }
+            }
+        }
+
+        void Report() const
+        {
+            std::size_t attacking = 0;
+            std::size_t safe_points = 0;
+            std::size_t safe_bytes = 0;
+            for (const auto &[form_id, state] : states)
+            {
+                attacking += state.is_attacking ? 1 : 0;
+                safe_points += state.safe_grounded_positions.size();
+                safe_bytes += state.safe_grounded_positions.capacity() * sizeof(LedgeProbes::Vec3);
+            }
+            const std::size_t window = std::min(latencies.total.size(), static_cast<std::size_t>(options.report_every / tick_seconds));
+            double window_max = 0.0;
+            for (std::size_t i = latencies.total.size() - window; i < latencies.total.size(); ++i)
+                window_max = std::max(window_max, latencies.total[i]);
+            std::printf("%7.0fs %8zu %10zu %12zu %10.1f %10.4f\n", now, states.size(), attacking, safe_points, safe_bytes / 1024.0, window_max);
+        }
+
+        const Options &options;
+        std::mt19937 random;
+        SyntheticWorld world;
+        LedgeProbes::Params params;
+        std::vector<SimActor> actors;
+        std::unordered_map<std::uint32_t, ActorState> states;
+        float now = 0.0f;
+        Latencies latencies;
+        std::uint64_t combat_events = 0;
+        std::uint64_t cleanups = 0;
+        std::uint64_t cleanup_visits = 0;
+        std::uint64_t decisions = 0;
+        std::uint64_t rays = 0;
+        std::uint64_t ledges = 0;
+        std::size_t peak_tracked = 0;
+        std::size_t peak_safe_points = 0;
+    };
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr, "usage: ledgestress [--actors N] [--seconds S] [--kernel ring|adaptive|sweep|reduced] [--lost-end-rate P]\n"
+                             "                   [--report-every S] [--seed N]\n");
+    }
+
+    bool ParseFloat(const char *text, float &value)
+    {
+        char *end = nullptr;
+        value = std::strtof(text, &end);
+        return end && *end == '\0' && value >= 0.0f;
+    }
+
+    bool ParseCount(const char *text, long &value)
+    {
+        char *end = nullptr;
+        value = std::strtol(text, &end, 10);
+        return end && *end == '\0' && value >= 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--actors" && has_value && ParseCount(argv[++i], options.actors))
+            continue;
+        else if (arg == "--seconds" && has_value && ParseFloat(argv[++i], options.seconds))
+            continue;
+        else if (arg == "--kernel" && has_value)
+            options.kernel = argv[++i];
+        else if (arg == "--lost-end-rate" && has_value && ParseFloat(argv[++i], options.lost_end_rate))
+            continue;
+        else if (arg == "--report-every" && has_value && ParseFloat(argv[++i], options.report_every) && options.report_every > 0.0f)
+            continue;
+        else if (arg == "--seed" && has_value && ParseCount(argv[++i], options.seed))
+            continue;
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (options.kernel != "ring" && options.kernel != "adaptive" && options.kernel != "sweep" && options.kernel != "reduced")
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    Simulation simulation(options);
+    simulation.Run();
+    simulation.Summary();
+    return 0;
+}
\ No newline at end of file
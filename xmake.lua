@@ -1,8 +1,10 @@
 -- set minimum xmake version
-set_xmakever("2.8.2")
+set_xmakever("2.8.5")
 
 -- includes
-includes("lib/commonlibsse-ng")
+if is_plat("windows") then
+    includes("lib/commonlibsse-ng")
+end
 
 -- set project
 set_project("AnimationLedgeBlockNG")
@@ -22,9 +24,12 @@ add_rules("plugin.vsxmake.autoupdate")
 add_rules("plugin.compile_commands.autoupdate", {outputdir = ".vscode"})
 
 -- CommonlibSSE-NG v4.0.0+
-add_cxflags("/Zc:preprocessor")
+if is_plat("windows") then
+    add_cxflags("/Zc:preprocessor")
+end
 
 -- targets
+if is_plat("windows") then
 target("AnimationLedgeBlockNG")
     -- add dependencies to target
     add_deps("commonlibsse-ng")
@@ -41,4 +46,60 @@ target("AnimationLedgeBlockNG")
     add_files("src/**.cpp")
     add_headerfiles("src/**.h")
     add_includedirs("src")
-    
+end
+
+-- offline ledge map baker, portable so it also builds on Linux
+target("ledgebake")
+    set_kind("binary")
+    add_files("tools/ledgebake/**.cpp", "src/LedgeMap.cpp")
+    add_headerfiles("src/LedgeMap.h")
+    add_includedirs("src")
+
+-- replays a recorded replay log through two probe variants and compares their decisions
+target("ledgereplay")
+    set_kind("binary")
+    add_files("tools/ledgereplay/**.cpp", "src/ReplayLog.cpp", "src/LedgeProbes.cpp")
+    add_headerfiles("src/ReplayLog.h", "src/LedgeProbes.h")
+    add_includedirs("src")
+
+-- microbenchmarks of the ledge check pipeline on a synthetic world, gate with:
+--   xmake run ledgebench --baseline tools/ledgebench/baseline.json
+target("ledgebench")
+    set_kind("binary")
+    set_optimize("fastest")
+    add_files("tools/ledgebench/**.cpp", "src/LedgeProbes.cpp")
+    add_headerfiles("src/LedgeProbes.h", "tools/common/SyntheticWorld.h")
+    add_includedirs("src", "tools/common")
+
+-- headless large-battle simulation of actor tracking and ledge checks
+target("ledgestress")
+    set_kind("binary")
+    set_optimize("fastest")
+    add_files("tools/ledgestress/**.cpp", "src/LedgeProbes.cpp", "src/AnimationTags.cpp")
+    add_headerfiles("src/LedgeProbes.h", "src/AnimationTags.h", "src/Tracking.h", "tools/common/SyntheticWorld.h")
+    add_includedirs("src", "tools/common")
+
+-- unit tests of the portable modules, run with: xmake test
+target("ledgemap_test")
+    set_kind("binary")
+    set_default(false)
+    add_files("tests/ledgemap/**.cpp", "src/LedgeMap.cpp")
+    add_headerfiles("src/LedgeMap.h", "tests/common/Check.h")
+    add_includedirs("src", "tests/common")
+    add_tests("default")
+
+target("ledgeprobes_test")
+    set_kind("binary")
+    set_default(false)
+    add_files("tests/ledgeprobes/**.cpp", "src/LedgeProbes.cpp")
+    add_headerfiles("src/LedgeProbes.h", "tests/common/Check.h")
+    add_includedirs("src", "tests/common")
+    add_tests("default")
+
+target("replaylog_test")
+    set_kind("binary")
+    set_default(false)
+    add_files("tests/replaylog/**.cpp", "src/ReplayLog.cpp")
+    add_headerfiles("src/ReplayLog.h", "tests/common/Check.h")
+    add_includedirs("src", "tests/common")
+    add_tests("default")